@@ -0,0 +1,208 @@
+// Microbenchmarks de los kernels de cada tick, medidos aislados y con
+// cantidades de entidades desde 40 hasta 100k. Escribe los resultados en
+// CSV por stdout para poder compararlos entre versiones.
+//
+// Uso: space_invaders_bench [--min-ms N] [--counts 40,400,...]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include "GameEngine.h"
+#include "ThreadManager.h"
+#include "GameRenderer.h"
+#include "WorldSnapshot.h"
+#include "Random.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Campo y formación para una cantidad de invasores: más ancha que alta,
+// con los sprites pegados (separación = ancho del sprite) y margen abajo
+// para que no se dispare el game over
+struct BenchField {
+    int columns, rows;
+    int width, height;
+
+    explicit BenchField(int count) {
+        columns = std::max(8, static_cast<int>(std::sqrt(count * 4.0)));
+        rows = (count + columns - 1) / columns;
+        width = columns * Sprites::invaderWidth() + 8;
+        height = rows * 2 + 16;
+    }
+};
+
+static void buildFormation(GameEngine& engine, const BenchField& field, int count) {
+    InvaderFormation* invaders = engine.getInvaders();
+    int spacing = Sprites::invaderWidth();
+
+    invaders->clear();
+    invaders->setOrigin(3, 3);
+    for (int i = 0; i < count; i++) {
+        int row = i / field.columns;
+        invaders->add((i % field.columns) * spacing, row * 2, Sprites::invaderForRow(row));
+    }
+    invaders->build();
+
+    engine.getInvaderMoveCounter() = 0;
+    engine.getInvaderDirection() = 1;
+    engine.getInvaderShootTimer() = 0;
+}
+
+// Llena ambos pools con proyectiles en posiciones aleatorias del campo
+static void fillBullets(GameEngine& engine, const BenchField& field, int count, Random& random) {
+    BulletPool* playerBullets = engine.getPlayerBullets();
+    BulletPool* invaderBullets = engine.getInvaderBullets();
+    playerBullets->clear();
+    invaderBullets->clear();
+
+    for (int i = 0; i < count; i++) {
+        int x = 1 + random.nextBelow(field.width - 2);
+        int y = 1 + random.nextBelow(field.height - 2);
+        if (i & 1) {
+            invaderBullets->spawn(x, y, 'v', 2);
+        } else {
+            playerBullets->spawn(x, y, '^', 3);
+        }
+    }
+}
+
+// También aplica los eventos pendientes, para que la cola no se llene
+// entre tandas de colisiones
+static void resetPlayState(GameEngine& engine) {
+    ThreadManager::scoreUpdateStep(&engine);
+    engine.setGameState(0);
+    engine.getPlayer()->lives = 1000000;
+}
+
+// Corre run() en tandas de batch llamadas, con prepare() fuera de la
+// medición antes de cada tanda, hasta juntar minMs de tiempo medido (o
+// diez veces eso de tiempo real, si prepare() domina). Devuelve
+// nanosegundos por llamada.
+static double measure(const std::function<void()>& prepare, const std::function<void()>& run,
+                      int batch, double minMs, long& calls) {
+    double totalNs = 0;
+    calls = 0;
+    auto wallStart = Clock::now();
+
+    while (calls < 4L * batch ||
+           (totalNs < minMs * 1e6 &&
+            std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count() < 10 * minMs)) {
+        prepare();
+        auto start = Clock::now();
+        for (int i = 0; i < batch; i++) {
+            run();
+        }
+        auto end = Clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+        calls += batch;
+    }
+
+    return totalNs / calls;
+}
+
+static void report(const char* kernel, int entities, long calls, double nsPerCall) {
+    printf("%s,%d,%ld,%.1f,%.3f\n", kernel, entities, calls, nsPerCall, nsPerCall / entities);
+    fflush(stdout);
+}
+
+static void benchCount(int count, double minMs) {
+    BenchField field(count);
+    Random random(count);
+
+    GameEngine engine(field.width, field.height);
+    engine.setBulletCapacity(count);
+    engine.startHeadless(1);
+    buildFormation(engine, field, count);
+    resetPlayState(engine);
+
+    long calls;
+    double ns;
+
+    // Un paso real de la formación por llamada (el contador se adelanta).
+    // Mover solo cambia el origen, así que basta con devolverlo a su lugar.
+    ns = measure([&] { engine.getInvaders()->setOrigin(3, 3); resetPlayState(engine); },
+                 [&] {
+                     engine.getInvaderMoveCounter() = 29;
+                     ThreadManager::invaderMovementStep(&engine);
+                 }, 64, minMs, calls);
+    report("invader_move", count, calls, ns);
+
+    // Un disparo real por llamada
+    ns = measure([&] { engine.getInvaderBullets()->clear(); resetPlayState(engine); },
+                 [&] {
+                     engine.getInvaderShootTimer() = 59;
+                     ThreadManager::invaderShootingStep(&engine);
+                 }, 64, minMs, calls);
+    report("invader_shoot", count, calls, ns);
+
+    // Pocas llamadas por tanda para que casi todos los proyectiles sigan en el campo
+    ns = measure([&] { fillBullets(engine, field, count, random); resetPlayState(engine); },
+                 [&] { ThreadManager::bulletUpdateStep(&engine); }, 4, minMs, calls);
+    report("bullet_update", count, calls, ns);
+
+    ns = measure([&] {
+                     buildFormation(engine, field, count);
+                     fillBullets(engine, field, count, random);
+                     resetPlayState(engine);
+                 },
+                 [&] { ThreadManager::collisionDetectionStep(&engine); }, 2, minMs, calls);
+    report("collision", count, calls, ns);
+
+    // Final de partida: solo quedan vivos los últimos invasores
+    buildFormation(engine, field, count);
+    for (int i = 0; i < count - std::max(1, count / 10); i++) {
+        engine.destroyInvader(i);
+    }
+    ns = measure([&] { resetPlayState(engine); },
+                 [&] { ThreadManager::gameStateStep(&engine); }, 64, minMs, calls);
+    report("game_state", count, calls, ns);
+
+    // Dibujo de un frame completo en el buffer en memoria (sin terminal)
+    buildFormation(engine, field, count);
+    fillBullets(engine, field, count, random);
+
+    WorldSnapshot world;
+    world.tick = 0;
+    world.width = field.width;
+    world.height = field.height;
+    world.player = engine.getPlayer()->entity;
+    engine.getInvaders()->snapshotTo(world.invaders);
+    world.playerBullets.assign(engine.getPlayerBullets()->begin(), engine.getPlayerBullets()->end());
+    world.invaderBullets.assign(engine.getInvaderBullets()->begin(), engine.getInvaderBullets()->end());
+
+    GameRenderer renderer;
+    ns = measure([] {},
+                 [&] {
+                     renderer.beginFrame(world.width, world.height);
+                     renderer.renderGameField(world);
+                 }, 8, minMs, calls);
+    report("render_offscreen", count, calls, ns);
+}
+
+int main(int argc, char* argv[]) {
+    double minMs = 50.0;
+    std::vector<int> counts = { 40, 400, 4000, 40000, 100000 };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            minMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--counts") == 0 && i + 1 < argc) {
+            counts.clear();
+            for (char* item = strtok(argv[++i], ","); item; item = strtok(nullptr, ",")) {
+                counts.push_back(std::max(1, atoi(item)));
+            }
+        }
+    }
+
+    printf("kernel,entities,calls,ns_per_call,ns_per_entity\n");
+    for (int count : counts) {
+        benchCount(count, minMs);
+    }
+
+    return 0;
+}
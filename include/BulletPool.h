@@ -0,0 +1,48 @@
+#ifndef BULLETPOOL_H
+#define BULLETPOOL_H
+
+#include <vector>
+#include "Entity.h"
+
+// Pool de proyectiles con capacidad fija. El almacenamiento se reserva una
+// sola vez; spawn() y despawn() son O(1) y nunca reservan memoria ni
+// desplazan elementos: despawn() mueve el último proyectil al hueco.
+// El orden de los proyectiles no se conserva.
+class BulletPool {
+private:
+    std::vector<Entity> bullets;
+    int count;
+    
+public:
+    static const int DEFAULT_CAPACITY = 256;
+    
+    explicit BulletPool(int capacity = DEFAULT_CAPACITY);
+    
+    void setCapacity(int capacity);     // Vacía el pool
+    void clear() { count = 0; }
+    
+    // Devuelve false si el pool está lleno
+    bool spawn(int x, int y, char symbol, int colorPair) {
+        if (count >= static_cast<int>(bullets.size())) {
+            return false;
+        }
+        bullets[count++] = Entity(x, y, symbol, colorPair);
+        return true;
+    }
+    
+    void despawn(int index) {
+        bullets[index] = bullets[--count];
+    }
+    
+    int size() const { return count; }
+    int capacity() const { return static_cast<int>(bullets.size()); }
+    bool full() const { return count >= capacity(); }
+    
+    Entity& operator[](int index) { return bullets[index]; }
+    const Entity& operator[](int index) const { return bullets[index]; }
+    
+    const Entity* begin() const { return bullets.data(); }
+    const Entity* end() const { return bullets.data() + count; }
+};
+
+#endif
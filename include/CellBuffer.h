@@ -0,0 +1,60 @@
+#ifndef CELLBUFFER_H
+#define CELLBUFFER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Atributos de una celda (independientes de ncurses)
+enum CellAttr : uint8_t {
+    CELL_NORMAL  = 0,
+    CELL_BOLD    = 1,
+    CELL_REVERSE = 2
+};
+
+// Una celda de pantalla: glifo, par de color y atributos
+struct Cell {
+    char ch;
+    uint8_t colorPair;
+    uint8_t attrs;
+    
+    bool operator==(const Cell& other) const {
+        return ch == other.ch && colorPair == other.colorPair && attrs == other.attrs;
+    }
+    bool operator!=(const Cell& other) const { return !(*this == other); }
+};
+
+// Pantalla en memoria. El renderizador dibuja aquí y luego compara contra
+// el frame anterior para mandar a la terminal solo las celdas que cambiaron.
+// Las escrituras fuera de rango se ignoran.
+class CellBuffer {
+private:
+    int width, height;
+    std::vector<Cell> cells;
+    
+public:
+    CellBuffer();
+    
+    void resize(int w, int h);
+    void fill(const Cell& cell);
+    void clear() { fill(Cell{' ', 0, CELL_NORMAL}); }
+    
+    void put(int x, int y, char ch, int colorPair = 0, int attrs = CELL_NORMAL) {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        cells[y * width + x] = Cell{ch, static_cast<uint8_t>(colorPair), static_cast<uint8_t>(attrs)};
+    }
+    void text(int x, int y, const std::string& s, int colorPair = 0, int attrs = CELL_NORMAL);
+    
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const Cell& at(int x, int y) const { return cells[y * width + x]; }
+    
+    void swap(CellBuffer& other) {
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        cells.swap(other.cells);
+    }
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+// Estructura para representar entidades del juego
+struct Entity {
+    int x, y;
+    char symbol;
+    bool active;
+    int colorPair;
+    
+    Entity(int _x = 0, int _y = 0, char _symbol = ' ', int _color = 0) 
+        : x(_x), y(_y), symbol(_symbol), active(true), colorPair(_color) {}
+};
+
+// Estructura para el jugador
+struct Player {
+    Entity entity;
+    int lives;
+    int score;
+    
+    Player() : lives(3), score(0) {
+        entity = Entity(0, 0, '*', 1);
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+
+// Qué hacer cuando un tick se atrasa más de un periodo
+enum class CatchUpPolicy {
+    Skip,   // Descartar los deadlines perdidos y seguir desde ahora
+    Burst   // Correr los ticks atrasados seguidos (hasta maxBurst) para recuperar
+};
+
+// Estadísticas del periodo real entre ticks
+struct PacerStats {
+    long ticks;             // Despertares medidos
+    double targetMs;        // Periodo objetivo
+    double meanMs;          // Periodo real promedio
+    double jitterMs;        // Desviación estándar del periodo real
+    double minMs, maxMs;
+    long missedDeadlines;   // Deadlines que ya habían pasado al despertar
+    long droppedTicks;      // Ticks descartados por la política de recuperación
+};
+
+// Ritmo de frames con deadlines absolutos sobre un reloj monótono. Cada
+// deadline es el anterior más un periodo, así que el tiempo de trabajo y la
+// latencia de despertar no se acumulan como con sleep_for().
+class FramePacer {
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    Clock::duration period;
+    Clock::time_point nextDeadline;
+    Clock::time_point lastWake;
+    bool started;
+    bool uncapped;          // Sin deadlines: waitNext() vuelve enseguida
+    CatchUpPolicy policy;
+    int maxBurst;
+    
+    // Estadísticas (Welford para media y varianza en línea)
+    long samples;
+    double mean, m2;
+    double minPeriod, maxPeriod;
+    long missed;
+    long dropped;
+    
+public:
+    explicit FramePacer(double hz = 60.0, CatchUpPolicy policy = CatchUpPolicy::Skip, int maxBurst = 4);
+    
+    void setRate(double hz);
+    void setUncapped(bool value) { uncapped = value; }
+    bool isUncapped() const { return uncapped; }
+    void setPolicy(CatchUpPolicy p, int burst) { policy = p; maxBurst = burst; }
+    double getRate() const;
+    
+    // Reinicia los deadlines (no las estadísticas): el primer tick es inmediato
+    void start();
+    
+    // Duerme hasta el próximo deadline y devuelve cuántos ticks correr
+    // (1, o más si hay que recuperar con CatchUpPolicy::Burst)
+    int waitNext();
+    
+    PacerStats getStats() const;
+};
+
+#endif
@@ -2,33 +2,28 @@
 #define GAMEENGINE_H
 
 #include <ncurses.h>
+#include <atomic>
 #include <vector>
 #include <string>
 #include "GameRenderer.h"
+#include "InvaderFormation.h"
+#include "Entity.h"
+#include "BulletPool.h"
+#include "WorldSnapshot.h"
+#include "Replay.h"
+#include "Random.h"
+#include "SpscQueue.h"
+#include "GameEvents.h"
 
 // Forward declaration para evitar dependencia circular
 class ThreadManager;
+class ScoreStore;
 
-// Estructura para representar entidades del juego
-struct Entity {
-    int x, y;
-    char symbol;
-    bool active;
-    int colorPair;
-    
-    Entity(int _x = 0, int _y = 0, char _symbol = ' ', int _color = 0) 
-        : x(_x), y(_y), symbol(_symbol), active(true), colorPair(_color) {}
-};
-
-// Estructura para el jugador
-struct Player {
-    Entity entity;
-    int lives;
+// Resultado de una partida terminada, para guardarlo fuera del tick
+struct FinishedGame {
     int score;
-    
-    Player() : lives(3), score(0) {
-        entity = Entity(0, 0, '*', 1);
-    }
+    int mode;
+    int wave;
 };
 
 class GameEngine {
@@ -37,50 +32,149 @@ private:
     ThreadManager* threadManager;
     
     Player player;
-    std::vector<Entity> invaders;
-    std::vector<Entity> playerBullets;
-    std::vector<Entity> invaderBullets;
+    InvaderFormation invaders;
+    FormationConfig formationOverrides; // Lo pedido por opciones (0 = según el modo)
+    FormationConfig formation;          // Lo que se usa en la partida actual
+    int currentWave;
+    BulletPool playerBullets;
+    BulletPool invaderBullets;
+    
+    // Instantáneas publicadas al final de cada tick para el renderizado
+    SnapshotBuffer snapshots;
+    long tickCount;             // Ticks desde el inicio de la partida
+    
+    // Interpolación: posiciones del último tick publicado (la instantánea
+    // siguiente las lleva como "anteriores") y lo último que se dibujó,
+    // para no repetir un frame idéntico
+    int publishedOriginX, publishedOriginY, publishedPlayerX;
+    bool interpolate;
+    long renderedTick;
+    InterpolatedPositions renderedAt;
+    std::chrono::steady_clock::time_point frameHeldUntil;  // Hasta cuándo no cambia
+    
+    // Semilla de la partida y grabación opcional de la entrada
+    uint64_t seed;
+    bool fixedSeed;
+    Random random;              // Generador propio de la partida
+    std::string recordPath;
+    InputRecorder recorder;
+    
+    // Partidas terminadas: las encola el tick y las guarda el hilo principal
+    SpscQueue<FinishedGame, 16> finishedGames;
+    ScoreStore* scoreStore;
+    
+    // Eventos del tick y lo que la fase de puntaje acumula con ellos
+    EventQueue events;
+    GameStats stats;
+    
+    // Ritmo de la formación (por partida, se reinicia con los invasores)
+    int invaderMoveCounter;
+    int invaderDirection;
+    int invaderShootTimer;
     
     int gameMode;
     int screenWidth, screenHeight;
-    int gameState; // 0: jugando, 1: pausa, 2: game over, 3: victoria
-    bool running;
-    bool playerShouldShoot;
+    // Los leen otros hilos (renderizado, principal) sin tomar locks
+    std::atomic<int> gameState; // 0: jugando, 1: pausa, 2: game over, 3: victoria
+    std::atomic<bool> running;
+    std::atomic<bool> playerShouldShoot;
+    bool headless;      // Sin terminal: tamaño de campo explícito y sin ncurses
+    bool showPerfOverlay;
     
     void initializeGame();
     void setupInvaders();
-    void showGameOverScreen();
-    void showVictoryScreen();
-    void showPauseScreen();
+    void seedRandom();
+    void sizeEventQueue();
+    void beginRecording();
+    void saveFinishedGames();
+    void showGameOverScreen(const WorldSnapshot& world);
+    void showVictoryScreen(const WorldSnapshot& world);
+    void showPauseScreen(const WorldSnapshot& world);
     
 public:
     GameEngine();
+    GameEngine(int width, int height); // Modo headless
     ~GameEngine();
     
     void startGame(int mode);
+    void startHeadless(int mode);
+    void tick();
     void pauseGame();
     void resumeGame();
     void resetGame();
-    void render();
+    // Dibuja la última instantánea; false si el frame sería igual al anterior
+    bool render();
+    // Antes de esto un render() más saldría igual (sin límite de FPS, el
+    // renderizado duerme hasta ahí)
+    std::chrono::steady_clock::time_point getFrameHeldUntil() const { return frameHeldUntil; }
+    void publishSnapshot();
+    void setInterpolation(bool enabled) { interpolate = enabled; }
+    void countTick() { tickCount++; }
+    long getTickCount() const { return tickCount; }
+    
+    // Con semilla fija la partida es reproducible; si no, se toma del reloj
+    void setSeed(uint64_t s) { seed = s; fixedSeed = true; }
+    uint64_t getSeed() const { return seed; }
+    Random& getRandom() { return random; }
+    
+    // Graba la entrada de cada partida en path (la última partida queda en
+    // el archivo). endRecording() cierra la grabación en el tick actual.
+    void setRecordPath(const std::string& path) { recordPath = path; }
+    InputRecorder* getRecorder() { return &recorder; }
+    void endRecording() { recorder.close(tickCount); }
+    
+    // Forma de la formación y oleadas (se aplica en la próxima partida)
+    void setFormationConfig(const FormationConfig& config) { formationOverrides = config; }
+    const FormationConfig& getFormationConfig() const { return formationOverrides; }
+    const FormationConfig& getFormation() const { return formation; }
+    int getWave() const { return currentWave; }
+    void nextWave();
+    
+    int& getInvaderMoveCounter() { return invaderMoveCounter; }
+    int& getInvaderDirection() { return invaderDirection; }
+    int& getInvaderShootTimer() { return invaderShootTimer; }
     
     // Getters para los hilos
     Player* getPlayer() { return &player; }
-    std::vector<Entity>* getInvaders() { return &invaders; }
-    std::vector<Entity>* getPlayerBullets() { return &playerBullets; }
-    std::vector<Entity>* getInvaderBullets() { return &invaderBullets; }
+    InvaderFormation* getInvaders() { return &invaders; }
+    BulletPool* getPlayerBullets() { return &playerBullets; }
+    BulletPool* getInvaderBullets() { return &invaderBullets; }
+    
+    // Capacidad fija de cada pool de proyectiles (reserva una sola vez)
+    void setBulletCapacity(int capacity);
     ThreadManager* getThreadManager() { return threadManager; }
+    GameRenderer* getRenderer() { return renderer; }
     
-    int getGameState() const { return gameState; }
-    void setGameState(int state) { gameState = state; }
+    // Consulta O(1) del invasor vivo en una celda (-1 si no hay). La
+    // rejilla es relativa a la formación, así que no se reconstruye al moverla.
+    int invaderAt(int x, int y) const { return invaders.at(x, y); }
+    void destroyInvader(int index) { invaders.kill(index); }
+    
+    int getGameState() const { return gameState.load(std::memory_order_acquire); }
+    void setGameState(int state) { gameState.store(state, std::memory_order_release); }
+    
+    // Termina la partida (2: game over, 3: victoria) y encola el resultado
+    void endGame(int state);
+    void setScoreStore(ScoreStore* store) { scoreStore = store; }
     
     int getScreenWidth() const { return screenWidth; }
     int getScreenHeight() const { return screenHeight; }
+    int getGameMode() const { return gameMode; }
+    bool isHeadless() const { return headless; }
+    
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    void setRunning(bool r) { running.store(r, std::memory_order_release); }
+    
+    void togglePerfOverlay() { showPerfOverlay = !showPerfOverlay; }
     
-    bool isRunning() const { return running; }
-    void setRunning(bool r) { running = r; }
+    bool shouldPlayerShoot() const { return playerShouldShoot.load(std::memory_order_acquire); }
+    void setPlayerShoot(bool shoot) { playerShouldShoot.store(shoot, std::memory_order_release); }
     
-    bool shouldPlayerShoot() const { return playerShouldShoot; }
-    void setPlayerShoot(bool shoot) { playerShouldShoot = shoot; }
+    // Eventos del tick: los emiten las fases (desde cualquier hilo del
+    // pool) y los consume la fase de puntaje
+    void emit(GameEventType type, int value = 0) { events.push(GameEvent{type, value}); }
+    EventQueue& getEvents() { return events; }
+    GameStats& getStats() { return stats; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef GAMEEVENTS_H
+#define GAMEEVENTS_H
+
+#include <cstdint>
+#include "MpscQueue.h"
+
+// Lo que pasó durante un tick. Las fases de simulación solo emiten eventos;
+// la fase de puntaje los consume y es la única que toca puntaje, vidas,
+// rachas y estadísticas.
+enum GameEventType : uint8_t {
+    EVT_SHOT_FIRED,         // El jugador disparó
+    EVT_INVADER_KILLED,     // value = índice del invasor
+    EVT_PLAYER_HIT,
+    EVT_WAVE_CLEARED        // value = oleada terminada
+};
+
+struct GameEvent {
+    GameEventType type;
+    int value;
+};
+
+typedef MpscQueue<GameEvent> EventQueue;
+
+// Rachas: matar otro invasor antes de COMBO_WINDOW ticks suma
+// COMBO_BONUS por cada invasor de la racha, hasta COMBO_MAX_BONUS
+struct GameStats {
+    static constexpr int KILL_POINTS = 10;
+    static constexpr int COMBO_WINDOW = 30;
+    static constexpr int COMBO_BONUS = 5;
+    static constexpr int COMBO_MAX_BONUS = 20;
+    static constexpr int WAVE_BONUS = 100;
+    
+    long shotsFired;
+    long invadersKilled;
+    long hitsTaken;
+    int combo;
+    int bestCombo;
+    long lastKillTick;
+    
+    GameStats() { reset(); }
+    
+    void reset() {
+        shotsFired = 0;
+        invadersKilled = 0;
+        hitsTaken = 0;
+        combo = 0;
+        bestCombo = 0;
+        lastKillTick = -COMBO_WINDOW;
+    }
+    
+    // Porcentaje de disparos que mataron un invasor
+    int accuracy() const {
+        if (shotsFired <= 0) {
+            return 0;
+        }
+        long percent = invadersKilled * 100 / shotsFired;
+        return static_cast<int>(percent > 100 ? 100 : percent);
+    }
+};
+
+#endif
@@ -4,31 +4,83 @@
 #include <ncurses.h>
 #include <vector>
 #include <string>
+#include "CellBuffer.h"
 
 // Forward declaration para evitar dependencias circulares
 struct Entity;
-struct Player;
+struct WorldSnapshot;
+struct InterpolatedPositions;
+class Sprite;
+class PerfStats;
+
+// Estadísticas de salida del último frame y acumuladas
+struct RenderStats {
+    long frames;
+    long cellsWritten;
+    long bytesWritten;      // Bytes hacia la terminal (control + glifos)
+    long syscalls;          // Llamadas a write() para mandarlos
+};
+
+// Cómo llega el frame a la terminal
+enum class OutputBackend {
+    Curses,     // mvaddch()/attrset() y refresh() de ncurses
+    Ansi        // Un buffer propio de secuencias CUP/SGR y un solo write()
+};
 
 class GameRenderer {
 private:
+    // Doble buffer: se dibuja en back y present() manda solo la diferencia
+    // contra front (lo que la terminal ya muestra)
+    CellBuffer front;
+    CellBuffer back;
+    bool frontValid;
+    
+    OutputBackend backend;
+    std::string output;     // Frame codificado en CUP/SGR (se reutiliza entre frames)
+    int ioFd;               // /proc/self/io, para medir lo que escribe ncurses
+    
+    RenderStats lastFrame;
+    RenderStats totals;
+    
+    void presentCurses();
+    void presentAnsi();
+    bool readWriteCounters(long& bytes, long& syscalls);
+    
     void drawBorder(int width, int height);
     void drawEntity(const Entity& entity);
+    void drawSprite(const Sprite& sprite, int frame, int x, int y, int colorPair);
     void drawBackground();
     
 public:
     GameRenderer();
     ~GameRenderer();
     
-    void renderGameField(const Player& player, 
-                        const std::vector<Entity>& invaders,
-                        const std::vector<Entity>& playerBullets,
-                        const std::vector<Entity>& invaderBullets,
-                        int screenWidth, int screenHeight);
+    // Empieza un frame vacío del tamaño dado
+    void beginFrame(int width, int height);
+    // Manda a la terminal solo las celdas que cambiaron
+    void present();
+    
+    // ANSI solo si la salida es una terminal con colores; si no, ncurses
+    void setBackend(OutputBackend requested);
+    OutputBackend getBackend() const { return backend; }
+    // Olvida lo que hay en pantalla: el próximo present() redibuja todo
+    void invalidate() { frontValid = false; }
+    
+    CellBuffer& getBuffer() { return back; }
+    
+    // Campo de juego en las posiciones del tick publicado, o en las dadas
+    // para la formación y el jugador (interpolación entre ticks)
+    void renderGameField(const WorldSnapshot& world);
+    void renderGameField(const WorldSnapshot& world, const InterpolatedPositions& at);
                         
-    void renderUI(int score, int lives, int gameMode);
+    void renderUI(int score, int lives, int gameMode, int wave, int waves);
+    void renderPerfOverlay(const PerfStats& stats);
+    void renderCenteredText(const std::vector<std::string>& lines, int startY, int colorPair);
     void renderStartScreen();
     void clearScreen();
+    
+    const RenderStats& getLastFrameStats() const { return lastFrame; }
+    const RenderStats& getTotalStats() const { return totals; }
 };
 
 #endif
-
@@ -0,0 +1,58 @@
+#ifndef INPUTHANDLER_H
+#define INPUTHANDLER_H
+
+#include <pthread.h>
+#include <atomic>
+#include <cstdint>
+#include "SpscQueue.h"
+
+// Comandos del jugador, ya decodificados de las teclas
+enum InputCommand : uint8_t {
+    CMD_NONE,
+    CMD_LEFT,
+    CMD_RIGHT,
+    CMD_FIRE,
+    CMD_PAUSE,          // Alterna pausa
+    CMD_QUIT,
+    CMD_RESTART,
+    CMD_TOGGLE_PERF
+};
+
+typedef SpscQueue<InputCommand, 256> CommandQueue;
+
+// Hilo de entrada orientado a eventos: duerme en poll() sobre stdin y
+// despierta apenas llega una tecla, la decodifica y la encola para la
+// simulación. No usa ncurses, así que no compite con el renderizado.
+class InputHandler {
+private:
+    pthread_t thread;
+    int inputFd;
+    int wakePipe[2];                    // Para despertar poll() al detenerse
+    std::atomic<bool> running;
+    CommandQueue& queue;
+    
+    // Aviso después de encolar, para despertar a quien duerme esperando
+    // entrada (el planificador en pausa)
+    void (*notify)(void*);
+    void* notifyArg;
+    
+    static void* inputFunc(void* arg);
+    void loop();
+    
+public:
+    InputHandler(CommandQueue& queue, int fd);
+    ~InputHandler();
+    
+    void start();
+    void stop();
+    
+    void setNotify(void (*callback)(void*), void* arg) { notify = callback; notifyArg = arg; }
+    
+    // Decodifica bytes crudos de la terminal (teclas y flechas ANSI). Si al
+    // final queda una secuencia de escape incompleta, *pendingFrom es el
+    // índice de su ESC; si no, -1.
+    static int decode(const unsigned char* bytes, int length,
+                      InputCommand* out, int maxOut, int* pendingFrom);
+};
+
+#endif
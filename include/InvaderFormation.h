@@ -0,0 +1,151 @@
+#ifndef INVADERFORMATION_H
+#define INVADERFORMATION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Sprite.h"
+
+// Forma de la formación y de la partida. Los campos en 0 toman el valor
+// del modo de juego (modo 1: 5 filas de 8, modo 2: 5 filas de 10).
+struct FormationConfig {
+    int rows;
+    int columns;
+    int spacingX;               // Columnas de pantalla entre invasores
+    int spacingY;               // Filas de pantalla entre filas de invasores
+    int waves;                  // Formaciones a destruir para ganar
+    int shootersPerVolley;      // Invasores que disparan en cada descarga
+    int lives;                  // Vidas iniciales del jugador
+    
+    FormationConfig()
+        : rows(0), columns(0), spacingX(0), spacingY(0), waves(1), shootersPerVolley(1),
+          lives(0) {}
+    
+    // Completa los campos en 0 según el modo
+    FormationConfig resolve(int mode) const;
+    int invaderCount() const { return rows * columns; }
+};
+
+// Parte inmutable de una formación: desplazamientos y sprites. Se comparte
+// por puntero con las instantáneas del renderizado, así que nunca se
+// modifica después de build(); una formación nueva crea otro layout.
+struct FormationLayout {
+    std::vector<int> offsetX;
+    std::vector<int> offsetY;
+    std::vector<SpriteId> sprites;
+};
+
+// Copia barata de una formación para el renderizado: layout compartido,
+// origen, cuadro de animación y máscara de vivos (una palabra por cada 64
+// invasores)
+struct FormationView {
+    std::shared_ptr<const FormationLayout> layout;
+    int originX, originY;
+    int frame;
+    std::vector<uint64_t> activeMask;
+    int count;
+    
+    FormationView() : originX(0), originY(0), frame(0), count(0) {}
+    
+    int size() const { return count; }
+    int x(int i) const { return originX + layout->offsetX[i]; }
+    int y(int i) const { return originY + layout->offsetY[i]; }
+    SpriteId sprite(int i) const { return layout->sprites[i]; }
+    bool isActive(int i) const { return (activeMask[i >> 6] >> (i & 63)) & 1; }
+};
+
+// Formación de invasores en coordenadas relativas: un origen común más un
+// desplazamiento fijo por invasor (estructura de arreglos), y una máscara
+// de bits con los vivos (64 por palabra).
+//
+// Mover la formación solo cambia el origen, así que pasos, rebotes en los
+// bordes y la consulta de la fila más baja cuestan O(1) sin importar
+// cuántos invasores haya. Para eso se mantienen de forma incremental los
+// vivos por columna y por fila y las columnas/filas vivas extremas.
+//
+// Cada invasor es un sprite de varias celdas anclado en su desplazamiento.
+// Los extremos (bordes, fila más baja) incluyen lo que el sprite ocupa a
+// cada lado del ancla, y cada paso de la formación avanza su animación.
+class InvaderFormation {
+private:
+    int originX, originY;
+    int frame;                          // Cuadro de animación (avanza con cada paso)
+    std::shared_ptr<FormationLayout> layout;
+    std::vector<uint64_t> activeMask;
+    int count;
+
+    // Rejilla local de anclas (desplazamientos) para los conteos por
+    // columna y fila
+    int gridWidth, gridHeight;
+    
+    // Rejilla local de celdas -> invasor cuyo sprite la cubre, o -1. Se
+    // extiende lo que los sprites sobresalen del ancla. Como es relativa
+    // al origen, no cambia cuando la formación se mueve.
+    std::vector<int> coverGrid;
+    int coverWidth, coverHeight;
+    int extentLeft, extentRight;        // Lo más que sobresale un sprite del ancla
+    int extentAbove, extentBelow;
+
+    std::vector<int> liveInColumn;
+    std::vector<int> liveInRow;
+    int minColumn, maxColumn;           // Columnas vivas extremas (desplazamiento)
+    int minRow, maxRow;                 // Filas vivas extremas (desplazamiento)
+    
+    // Índices de los vivos, sin orden, y la posición de cada uno en la
+    // lista (-1 si murió). kill() lo quita con swap-remove.
+    std::vector<int> liveList;
+    std::vector<int> livePosition;
+
+public:
+    static const int COLOR_PAIR_ID = 2;
+
+    InvaderFormation();
+
+    void clear();
+    void setOrigin(int x, int y) { originX = x; originY = y; }
+    void add(int dx, int dy, SpriteId sprite);
+    void build();                       // Llamar una vez después de los add()
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    int x(int i) const { return originX + layout->offsetX[i]; }
+    int y(int i) const { return originY + layout->offsetY[i]; }
+    SpriteId sprite(int i) const { return layout->sprites[i]; }
+    int getFrame() const { return frame; }
+    bool isActive(int i) const { return (activeMask[i >> 6] >> (i & 63)) & 1; }
+    void kill(int i);
+    
+    // Fila más baja que ocupa el sprite del invasor (de ahí sale su disparo)
+    int bottomY(int i) const { return y(i) + Sprites::get(sprite(i)).below(); }
+
+    // Copia el estado actual para el renderizado sin reservar memoria
+    // (una vez que la máscara de la vista tiene el tamaño necesario)
+    void snapshotTo(FormationView& view) const;
+    
+    // Invasor vivo cuyo sprite, en el cuadro actual, es sólido en la celda
+    // absoluta (x, y), o -1. Una consulta a la rejilla y un AND con la
+    // máscara de la fila del sprite.
+    int at(int x, int y) const;
+
+    // Movimiento O(1): solo cambia el origen (y el cuadro de animación)
+    void stepX(int dx) { originX += dx; frame++; }
+    void dropY() { originY++; }
+
+    // Vivos en O(1): candidatos para disparar y chequeo de victoria sin
+    // recorrer la formación
+    int liveCount() const { return static_cast<int>(liveList.size()); }
+    int liveAt(int k) const { return liveList[k]; }
+    
+    bool hasLive() const { return minColumn <= maxColumn; }
+    int leftmostX() const { return originX + minColumn - extentLeft; }
+    int rightmostX() const { return originX + maxColumn + extentRight; }
+    int lowestY() const { return originY + maxRow + extentBelow; }
+
+    // ¿Alguna celda de un invasor vivo está en x <= minX o x >= maxX?
+    bool anyActiveOutside(int minX, int maxX) const {
+        return hasLive() && (leftmostX() <= minX || rightmostX() >= maxX);
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LOCKPROFILE_H
+#define LOCKPROFILE_H
+
+#include <pthread.h>
+#include <cstdint>
+#include <string>
+
+// Perfil de contención de locks. Compilado con -DLOCK_PROFILE (make profile)
+// cada ProfiledMutex cuenta, por lock y por hilo que lo toma, cuántas veces
+// se tomó, cuántas tuvo que esperar, cuánto esperó y cuánto lo retuvo. Sin
+// la bandera son envolturas directas de pthreads.
+//
+// Las cuentas se agrupan por nombre: los locks de varios motores (sesiones
+// headless) con el mismo nombre suman en la misma fila.
+class LockProfile {
+public:
+    static bool enabled();
+
+    // Nombra el hilo actual en el perfil y en el sistema (top -H, gdb).
+    // El nombre debe vivir todo el programa (un literal).
+    static void nameThread(const char* name);
+
+    // Tabla ordenada por espera total: qué lock y qué hilo serializan más.
+    // Vacía si no se compiló con LOCK_PROFILE.
+    static std::string report();
+};
+
+struct LockRecord;
+
+class ProfiledMutex {
+private:
+    pthread_mutex_t mutex;
+#ifdef LOCK_PROFILE
+    LockRecord* record;
+    uint64_t acquiredAt;        // Solo los toca quien tiene el lock
+    int holder;
+
+    void acquired(int slot, uint64_t waitNs, bool contended);
+    void releasing();
+#endif
+
+public:
+    explicit ProfiledMutex(const char* name);
+    ~ProfiledMutex();
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+#ifdef LOCK_PROFILE
+    void lock();
+    void unlock();
+    // pthread_cond_wait(): lo que dura dormido no cuenta como retenido
+    void wait(pthread_cond_t* condition);
+#else
+    void lock() { pthread_mutex_lock(&mutex); }
+    void unlock() { pthread_mutex_unlock(&mutex); }
+    void wait(pthread_cond_t* condition) { pthread_cond_wait(condition, &mutex); }
+#endif
+};
+
+#endif
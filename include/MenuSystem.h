@@ -2,29 +2,51 @@
 #define MENUSYSTEM_H
 
 #include <ncurses.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 
+class ScoreStore;
+
 class MenuSystem {
 private:
     int selectedOption;
+    ScoreStore* scoreStore;
     std::vector<std::string> mainMenuOptions;
     int screenWidth, screenHeight;
     
-    void drawBorder();
-    void drawTitle();
-    void drawOptions(const std::vector<std::string>& options, int selected);
-    void drawFooter();
-    void centerText(int y, const std::string& text, int colorPair = 0);
+    // Pantallas pre-dibujadas del tamaño de la terminal. Se arman una vez
+    // por tamaño y mostrarlas es copiar celdas a stdscr: refresh() solo
+    // manda a la terminal lo que cambió.
+    WINDOW* menuPad;            // Borde, título y pie del menú principal
+    WINDOW* instructionsPad;
+    WINDOW* scoresPad;
+    uint64_t scoresPadRecords;  // Partidas guardadas cuando se armó scoresPad
+    
+    void drawBorder(WINDOW* win);
+    void drawTitle(WINDOW* win);
+    void drawOptionRow(int index, bool selected);
+    void drawFooter(WINDOW* win);
+    void centerText(WINDOW* win, int y, const std::string& text, int colorPair = 0);
+    
+    bool updateScreenSize();
+    void freePads();
+    WINDOW* buildMenuPad();
+    WINDOW* buildInstructionsPad();
+    WINDOW* buildScoresPad();
+    void showPad(WINDOW* pad);
+    void repaintMainMenu();
+    int waitForKey();
     
 public:
     MenuSystem();
     ~MenuSystem();
     
+    void setScoreStore(ScoreStore* store) { scoreStore = store; }
+    
     int showMainMenu();
     void showInstructions();
     void showHighScores();
-    void waitForKey();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Cola sin locks de varios productores y un solo consumidor, con capacidad
+// fija (se redondea a potencia de 2). Cada slot lleva un número de
+// secuencia: un productor reserva su posición con un CAS sobre tail y
+// publica el slot con la secuencia; el consumidor lee en orden sin CAS.
+//
+// setCapacity() solo puede llamarse cuando nadie está usando la cola.
+template <typename T>
+class MpscQueue {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+    
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail;   // Siguiente a reservar (productores)
+    alignas(64) size_t head;                // Siguiente a leer (consumidor)
+    
+public:
+    explicit MpscQueue(size_t capacity = 64) : mask(0), tail(0), head(0) {
+        setCapacity(capacity);
+    }
+    
+    void setCapacity(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        
+        slots.reset(new Slot[size]);
+        mask = size - 1;
+        clear();
+    }
+    
+    size_t capacity() const { return mask + 1; }
+    
+    // Vacía la cola (sin productores ni consumidor activos)
+    void clear() {
+        for (size_t i = 0; i <= mask; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        tail.store(0, std::memory_order_relaxed);
+        head = 0;
+    }
+    
+    // Productor (cualquier hilo). Devuelve false si la cola está llena.
+    bool push(const T& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            
+            if (difference == 0) {
+                // Libre: intentar reservarlo
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // El consumidor todavía no liberó este slot: llena
+                return false;
+            } else {
+                // Otro productor ganó la posición
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Consumidor. Devuelve false si la cola está vacía.
+    bool pop(T& item) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        
+        item = slot.item;
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+};
+
+#endif
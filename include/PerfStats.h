@@ -0,0 +1,116 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Histograma de latencias con cubetas fijas: 4 sub-cubetas por potencia de
+// 2 de nanosegundos (error relativo < 25%). Registrar es O(1) y sin locks;
+// los contadores son atómicos para que otro hilo pueda leerlos en vivo.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 4;
+    static const int BUCKETS = 64 * SUB_BUCKETS;
+    
+private:
+    std::atomic<uint32_t> counts[BUCKETS];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> maxNs;
+    
+    static int bucketFor(uint64_t ns);
+    static uint64_t bucketUpperBound(int bucket);
+    
+public:
+    LatencyHistogram();
+    
+    void record(uint64_t ns);
+    void reset();
+    
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maxNs.load(std::memory_order_relaxed); }
+    // Percentil aproximado (límite superior de la cubeta), en ns
+    uint64_t percentile(double p) const;
+};
+
+// Tiempos por fase del tick, del renderizado y de espera de locks
+class PerfStats {
+public:
+    enum Phase {
+        INPUT,
+        PLAYER,
+        INVADERS,
+        BULLETS,
+        COLLISION,
+        STATE,
+        SCORE,
+        TICK,               // Tick completo
+        RENDER,             // Frame completo (dibujar + present)
+        ENTITY_LOCK_WAIT,   // Espera para tomar entityMutex
+        RENDER_LOCK_WAIT,   // Espera para tomar renderMutex
+        PHASE_COUNT
+    };
+    
+    // Duración de la ventana del recuadro en vivo
+    static constexpr int WINDOW_MS = 1000;
+    
+    PerfStats() : activeWindow(0), windowStart(std::chrono::steady_clock::now()), enabled(true) {}
+    
+    static const char* phaseName(int phase);
+    
+    // Desactivado, los timers no leen el reloj (modo headless sin --perf)
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+    
+    void record(Phase phase, uint64_t ns) {
+        histograms[phase].record(ns);
+        windows[activeWindow.load(std::memory_order_relaxed)][phase].record(ns);
+    }
+    const LatencyHistogram& get(Phase phase) const { return histograms[phase]; }
+    void reset();
+    
+    // El recuadro en vivo muestra la última ventana completa, no el total
+    // desde el arranque. advanceWindow() la cambia cuando pasó WINDOW_MS;
+    // la llama solo quien dibuja el recuadro.
+    void advanceWindow(std::chrono::steady_clock::time_point now);
+    const LatencyHistogram& recent(Phase phase) const {
+        return windows[activeWindow.load(std::memory_order_relaxed) ^ 1][phase];
+    }
+    
+    // Tabla con count/p50/p99/max por fase, para imprimir al salir
+    std::string report() const;
+    
+private:
+    LatencyHistogram histograms[PHASE_COUNT];
+    LatencyHistogram windows[2][PHASE_COUNT];     // En curso y última completa
+    std::atomic<int> activeWindow;
+    std::chrono::steady_clock::time_point windowStart;
+    bool enabled;
+};
+
+// Formato corto para una duración: "850ns", "12.3us", "4.1ms"
+std::string formatDuration(uint64_t ns);
+
+// Mide el tiempo de vida del objeto y lo registra en una fase
+class ScopedPhaseTimer {
+private:
+    PerfStats& stats;
+    PerfStats::Phase phase;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+    
+public:
+    ScopedPhaseTimer(PerfStats& s, PerfStats::Phase p)
+        : stats(s), phase(p), active(s.isEnabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    
+    ~ScopedPhaseTimer() {
+        if (!active) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.record(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+#endif
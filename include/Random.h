@@ -0,0 +1,52 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Generador xoshiro256** por partida: 32 bytes de estado, sin locks ni
+// estado global, y la misma secuencia para la misma semilla en cualquier
+// plataforma (a diferencia de rand()).
+class Random {
+private:
+    uint64_t state[4];
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+public:
+    explicit Random(uint64_t seedValue = 0) { seed(seedValue); }
+    
+    // splitmix64 expande la semilla para que nunca quede el estado en cero
+    void seed(uint64_t seedValue) {
+        for (int i = 0; i < 4; i++) {
+            seedValue += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seedValue;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+    
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        
+        return result;
+    }
+    
+    // Entero en [0, bound) por multiplicación en vez de la división de %
+    // (el sesgo es despreciable para los rangos del juego)
+    uint32_t nextBelow(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+};
+
+#endif
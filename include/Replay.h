@@ -0,0 +1,73 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "InputHandler.h"
+#include "InvaderFormation.h"
+
+// Todo lo que decide el resultado de una partida además de la entrada
+struct ReplayHeader {
+    uint64_t seed;
+    int mode;
+    int width, height;
+    int bulletCapacity;
+    FormationConfig formation;      // Tal como se pidió (0 = según el modo)
+};
+
+// Graba la semilla y los comandos del jugador marcados con el tick en que
+// la simulación los consumió. Como la entrada solo se aplica al inicio de
+// un tick, eso basta para reproducir la partida tick por tick sin importar
+// cómo se intercalaron los hilos.
+//
+// Formato: cabecera fija y luego un registro por comando con la distancia
+// en ticks al anterior (varint) y el comando (1 byte). La mayoría de los
+// registros ocupan 2 bytes. Un registro con CMD_NONE marca el final.
+class InputRecorder {
+private:
+    FILE* file;
+    long lastTick;
+    
+    void writeVarint(uint64_t value);
+    
+public:
+    InputRecorder();
+    ~InputRecorder();
+    
+    bool open(const std::string& path, const ReplayHeader& header);
+    bool isOpen() const { return file != nullptr; }
+    void record(long tick, InputCommand cmd);
+    void close(long finalTick);         // Escribe el marcador de fin
+};
+
+// Lee una grabación completa y entrega los comandos en orden de tick
+class InputReplay {
+private:
+    std::vector<uint8_t> data;
+    size_t pos;
+    ReplayHeader header;
+    
+    long nextTick;                      // Tick del siguiente comando (-1 si no hay)
+    InputCommand nextCommand;
+    long endTick;                       // Tick final grabado (-1 si la grabación se cortó)
+    
+    bool readVarint(uint64_t& value);
+    void advance();
+    
+public:
+    InputReplay();
+    
+    // Devuelve false y describe el problema en error si el archivo no sirve
+    bool load(const std::string& path, std::string& error);
+    
+    const ReplayHeader& getHeader() const { return header; }
+    long getEndTick() const { return endTick; }
+    bool finished() const { return nextTick < 0; }
+    
+    // Saca el siguiente comando si corresponde al tick indicado
+    bool pop(long tick, InputCommand& cmd);
+};
+
+#endif
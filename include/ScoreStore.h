@@ -0,0 +1,86 @@
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Un puntaje guardado. Registros de tamaño fijo (32 bytes) con su propio
+// CRC, así que un registro a medio escribir se detecta y se ignora.
+struct ScoreRecord {
+    uint32_t crc;
+    int32_t score;
+    int64_t timestamp;          // Segundos desde epoch, no decreciente en el archivo
+    uint8_t mode;
+    uint8_t wave;
+    uint16_t reserved;
+    char name[12];
+};
+
+// Entrada del índice de mejores puntajes de la cabecera
+struct ScoreIndexEntry {
+    int32_t score;
+    uint32_t record;
+    int64_t timestamp;
+};
+
+// Archivo de puntajes de solo-agregar, mapeado en memoria.
+//
+// Estructura: dos copias de la cabecera (se escribe siempre la más vieja
+// y se elige al abrir la de secuencia mayor con CRC válido) y después los
+// registros en orden de llegada. Cada cabecera guarda cuántos registros
+// están confirmados y los TOP_K mejores por modo, así que abrir el archivo
+// y mostrar la tabla no depende de cuántas partidas haya guardadas.
+//
+// Como los registros quedan ordenados por fecha, un rango de fechas se
+// ubica con búsqueda binaria y solo se recorre ese tramo.
+//
+// Varios procesos pueden compartir el archivo: agregar toma flock().
+class ScoreStore {
+public:
+    static const int MAX_MODES = 4;
+    static const int TOP_K = 16;
+
+private:
+    std::string path;
+    int fd;
+    const uint8_t* map;         // Mapeo de solo lectura del archivo
+    size_t mapSize;
+
+    uint64_t sequence;          // Secuencia de la cabecera vigente
+    uint64_t recordCount;
+    ScoreIndexEntry top[MAX_MODES][TOP_K];
+    uint32_t topCount[MAX_MODES];
+
+    bool loadHeader();
+    bool writeHeader();
+    void recoverTail();
+    void rebuildIndex();
+    void insertTop(const ScoreRecord& record, uint32_t index);
+    bool remap();
+    const ScoreRecord* recordAt(uint64_t index) const;
+
+public:
+    ScoreStore();
+    ~ScoreStore();
+
+    // Abre o crea el archivo. Devuelve false si no se pudo.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    const std::string& getPath() const { return path; }
+
+    // Agrega un puntaje y actualiza el índice (seguro ante caídas)
+    bool append(int score, int mode, int wave, const std::string& name);
+
+    uint64_t size() const { return recordCount; }
+
+    // Mejores k del modo (0 = todos los modos) según el índice: O(k)
+    std::vector<ScoreRecord> topScores(int mode, int k) const;
+
+    // Mejores k del modo con fecha en [from, to): búsqueda binaria del
+    // tramo y un recorrido solo de ese tramo
+    std::vector<ScoreRecord> topScoresBetween(int mode, int64_t from, int64_t to, int k) const;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SESSIONHOST_H
+#define SESSIONHOST_H
+
+#include <cstdint>
+#include <vector>
+#include "GameEngine.h"
+#include "WorkerPool.h"
+
+// Parámetros comunes de las sesiones de un host
+struct SessionConfig {
+    int width, height;
+    int mode;
+    int bulletCapacity;
+    FormationConfig formation;
+    uint64_t seed;              // La sesión i usa seed + i
+};
+
+// Corre muchas partidas headless independientes en un pool fijo de hilos.
+// Cada sesión es un GameEngine sin hilos propios y con todo su estado
+// adentro (formación, temporizadores, generador), así que las sesiones no
+// comparten nada y cualquier trabajador puede avanzar cualquiera.
+class SessionHost {
+private:
+    struct Session {
+        GameEngine* engine;
+        int sweep;                      // Dirección del piloto automático
+        long gamesFinished;
+    };
+    
+    std::vector<Session> sessions;
+    WorkerPool pool;
+    
+public:
+    SessionHost(int sessionCount, const SessionConfig& config, int workerThreads);
+    ~SessionHost();
+    
+    // Avanza cada sesión ticks ticks. Las sesiones se reparten
+    // dinámicamente entre los trabajadores y el hilo que llama.
+    void run(long ticks);
+    
+    int size() const { return static_cast<int>(sessions.size()); }
+    int threads() const { return pool.size() + 1; }
+    long gamesFinished() const;
+    
+    // Un tick de piloto automático: barre la nave, dispara siempre y
+    // reinicia las partidas terminadas, todo por la cola de comandos
+    static void autopilot(GameEngine& engine, int& sweep, long& gamesFinished);
+};
+
+#endif
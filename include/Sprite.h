@@ -0,0 +1,81 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <cstdint>
+
+// Dibujo de varias celdas con cuadros de animación. Las celdas sólidas de
+// cada fila se precalculan como máscara de bits (bit c = columna c), así
+// que saber si una celda toca el sprite es un AND, sin comparar celda por
+// celda. Las posiciones se dan por el ancla: la celda del sprite que cae
+// en la posición de la entidad.
+class Sprite {
+public:
+    static constexpr int MAX_WIDTH = 16;
+    static constexpr int MAX_HEIGHT = 4;
+    static constexpr int MAX_FRAMES = 2;
+
+private:
+    int width, height, frames;
+    int anchorX, anchorY;
+    char glyphs[MAX_FRAMES][MAX_HEIGHT][MAX_WIDTH];
+    uint16_t rowMasks[MAX_FRAMES][MAX_HEIGHT];
+
+public:
+    // art: frames * height filas, primero todas las del cuadro 0, todas del
+    // mismo ancho. ' ' es transparente y no cuenta para colisiones.
+    Sprite(const char* const* art, int frames, int height, int anchorX, int anchorY);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int frameCount() const { return frames; }
+
+    // Celdas del sprite a cada lado del ancla
+    int left() const { return anchorX; }
+    int right() const { return width - 1 - anchorX; }
+    int above() const { return anchorY; }
+    int below() const { return height - 1 - anchorY; }
+
+    // Celda (column, row) desde la esquina superior izquierda
+    char glyph(int frame, int row, int column) const { return glyphs[frame % frames][row][column]; }
+    uint16_t rowMask(int frame, int row) const { return rowMasks[frame % frames][row]; }
+
+    // ¿La celda a (dx, dy) del ancla es sólida en el cuadro dado?
+    bool hits(int frame, int dx, int dy) const {
+        int row = dy + anchorY;
+        int column = dx + anchorX;
+        if (row < 0 || row >= height || column < 0 || column >= width) {
+            return false;
+        }
+        return (rowMasks[frame % frames][row] & (1u << column)) != 0;
+    }
+};
+
+// Sprites del juego
+enum SpriteId : uint8_t {
+    SPRITE_SQUID,       // Invasor W
+    SPRITE_CRAB,        // Invasor @
+    SPRITE_OCTOPUS,     // Invasor ^
+    SPRITE_PLAYER,
+    SPRITE_COUNT
+};
+
+class Sprites {
+public:
+    // Ticks entre cuadros de la nave (los invasores cambian de cuadro con
+    // cada paso de la formación)
+    static constexpr int PLAYER_FRAME_TICKS = 15;
+
+    static const Sprite& get(SpriteId id);
+
+    // Tipo de invasor de cada fila de la formación
+    static SpriteId invaderForRow(int row);
+
+    // Ancho y alto máximos de los invasores: la separación mínima para que
+    // dos invasores no se encimen
+    static int invaderWidth();
+    static int invaderHeight();
+
+    static int playerFrame(long tick) { return static_cast<int>(tick / PLAYER_FRAME_TICKS); }
+};
+
+#endif
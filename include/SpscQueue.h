@@ -0,0 +1,49 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Cola sin locks de un solo productor y un solo consumidor, con capacidad
+// fija (potencia de 2). El productor solo escribe tail y el consumidor
+// solo escribe head, así que basta con acquire/release.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity debe ser potencia de 2");
+    
+private:
+    alignas(64) std::atomic<size_t> head;   // Siguiente a leer (consumidor)
+    alignas(64) std::atomic<size_t> tail;   // Siguiente a escribir (productor)
+    T items[Capacity];
+    
+public:
+    SpscQueue() : head(0), tail(0) {}
+    
+    // Productor. Devuelve false si la cola está llena.
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumidor. Devuelve false si la cola está vacía.
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -2,9 +2,12 @@
 #define THREADMANAGER_H
 
 #include <pthread.h>
-#include <semaphore.h>
 #include <vector>
 #include "GameEngine.h"
+#include "FramePacer.h"
+#include "PerfStats.h"
+#include "InputHandler.h"
+#include "LockProfile.h"
 
 // Estructura para pasar datos a los hilos
 struct ThreadData {
@@ -13,67 +16,116 @@ struct ThreadData {
     bool* running;
 };
 
+class WorkerPool;
+
 class ThreadManager {
 private:
-    // Hilos del juego
-    pthread_t playerMovementThread;
-    pthread_t playerShootingThread;
-    pthread_t invaderMovementThread;
-    pthread_t invaderShootingThread;
-    pthread_t bulletUpdateThread;
-    pthread_t collisionDetectionThread;
+    // Hilos del juego: el planificador de ticks y el renderizado.
+    // Las fases de cada tick corren en un pool pequeño de trabajadores.
+    pthread_t tickThread;
     pthread_t renderThread;
-    pthread_t inputHandlerThread;
-    pthread_t scoreUpdateThread;
-    pthread_t gameStateThread;
+    WorkerPool* workerPool;
+    
+    // Entrada: un hilo dormido en poll() que encola comandos; la fase de
+    // entrada de cada tick vacía la cola
+    InputHandler* inputHandler;
+    CommandQueue commandQueue;
+    
+    // Mecanismos de sincronización (con make profile miden su contención)
+    ProfiledMutex entityMutex;          // Protege acceso a entidades
+    ProfiledMutex scoreMutex;           // Protege el puntaje
+    ProfiledMutex gameStateMutex;       // Protege el estado del juego
+    ProfiledMutex renderMutex;          // Protege la terminal (ncurses no es thread-safe)
     
-    // Mecanismos de sincronización
-    pthread_mutex_t entityMutex;        // Protege acceso a entidades
-    pthread_mutex_t scoreMutex;         // Protege el puntaje
-    pthread_mutex_t gameStateMutex;     // Protege el estado del juego
-    pthread_mutex_t renderMutex;        // Protege el renderizado
+    // En pausa y al terminar la partida no hay nada que simular: los hilos
+    // duermen en estas condiciones (con gameStateMutex) en vez de despertar
+    // en cada tick
+    pthread_cond_t renderCondition;     // Despierta al renderizado dormido
+    pthread_cond_t wakeCondition;       // Despierta al planificador dormido
+    pthread_cond_t stateCondition;      // Avisa al hilo principal
+    bool tickParked;                    // El planificador está dormido
+    bool wakePending;                   // Llegó entrada desde el último tick
+    bool renderPending;                 // Falta dibujar el frame del último tick
+    bool stateChanged;                  // Terminó una partida o se pidió salir
     
-    sem_t playerActionSem;              // Semáforo para acciones del jugador
-    sem_t invaderActionSem;             // Semáforo para acciones de invasores
+    // Ritmo por deadlines absolutos de cada hilo
+    FramePacer tickPacer;
+    FramePacer renderPacer;
     
-    pthread_barrier_t updateBarrier;    // Barrera de sincronización para updates
-    pthread_cond_t renderCondition;     // Variable de condición para renderizado
+    // Histogramas de tiempo por fase
+    PerfStats perfStats;
     
     // Datos compartidos
-    ThreadData threadDataArray[10];
+    ThreadData threadDataArray[2];
     GameEngine* gameEngine;
     bool threadsRunning;
     
     // Funciones estáticas para los hilos (requisito de pthreads)
-    static void* playerMovementFunc(void* arg);
-    static void* playerShootingFunc(void* arg);
-    static void* invaderMovementFunc(void* arg);
-    static void* invaderShootingFunc(void* arg);
-    static void* bulletUpdateFunc(void* arg);
-    static void* collisionDetectionFunc(void* arg);
+    static void* tickFunc(void* arg);
     static void* renderFunc(void* arg);
-    static void* inputHandlerFunc(void* arg);
-    static void* scoreUpdateFunc(void* arg);
-    static void* gameStateFunc(void* arg);
+    
+    // Fases del tick. Se ejecutan en orden de dependencias:
+    // entrada -> {jugador, invasores} -> proyectiles -> colisiones -> puntaje -> estado
+    // Las fases emiten eventos (GameEvents.h) y puntaje los aplica antes de
+    // que estado decida derrota o victoria en el mismo tick
+    static void inputPhase(GameEngine* engine);
+    static void playerPhase(GameEngine* engine);
+    static void invaderPhase(GameEngine* engine);
+    void runPhase(PerfStats::Phase phase, void (*fn)(GameEngine*));
+    
+    void parkTicks();
+    void parkRender();
+    static void wakeFromInput(void* arg);
     
 public:
+    // Pasos de un tick de simulación, sin sincronización. Son públicos para
+    // que el benchmark (bench/) los mida aislados.
+    static void playerMovementStep(GameEngine* engine);
+    static void playerShootingStep(GameEngine* engine);
+    static void invaderMovementStep(GameEngine* engine);
+    static void invaderShootingStep(GameEngine* engine);
+    static void bulletUpdateStep(GameEngine* engine);
+    static void collisionDetectionStep(GameEngine* engine);
+    static void scoreUpdateStep(GameEngine* engine);
+    static void gameStateStep(GameEngine* engine);
+    
+
     ThreadManager(GameEngine* engine);
     ~ThreadManager();
     
     void startThreads();
     void stopThreads();
-    void pauseThreads();
-    void resumeThreads();
+    void runTick();
+    
+    // Hay entrada nueva: despierta al planificador si estaba dormido
+    void wake();
+    
+    // El hilo principal duerme en waitStateChange() hasta que termina una
+    // partida (hay puntaje que guardar) o se pide salir
+    void notifyStateChange();
+    void waitStateChange();
+    
+    void setTickRate(double hz, CatchUpPolicy policy) { tickPacer.setRate(hz); tickPacer.setPolicy(policy, 4); }
+    PacerStats getTickStats() const { return tickPacer.getStats(); }
+    double getTickRate() const { return tickPacer.getRate(); }
+    
+    // Frames por segundo del renderizado, independiente de los ticks
+    // (0 = sin límite)
+    void setRenderRate(double fps) {
+        renderPacer.setUncapped(fps <= 0);
+        if (fps > 0) renderPacer.setRate(fps);
+    }
+    PacerStats getRenderStats() const { return renderPacer.getStats(); }
+    PerfStats& getPerfStats() { return perfStats; }
+    
+    // Cola de comandos del jugador (el modo headless encola aquí directamente)
+    CommandQueue& getCommandQueue() { return commandQueue; }
     
     // Getters para los mutexes (usados por GameEngine)
-    pthread_mutex_t* getEntityMutex() { return &entityMutex; }
-    pthread_mutex_t* getScoreMutex() { return &scoreMutex; }
-    pthread_mutex_t* getGameStateMutex() { return &gameStateMutex; }
-    pthread_mutex_t* getRenderMutex() { return &renderMutex; }
-    
-    // Getters para semáforos
-    sem_t* getPlayerActionSem() { return &playerActionSem; }
-    sem_t* getInvaderActionSem() { return &invaderActionSem; }
+    ProfiledMutex* getEntityMutex() { return &entityMutex; }
+    ProfiledMutex* getScoreMutex() { return &scoreMutex; }
+    ProfiledMutex* getGameStateMutex() { return &gameStateMutex; }
+    ProfiledMutex* getRenderMutex() { return &renderMutex; }
     
     bool isRunning() const { return threadsRunning; }
 };
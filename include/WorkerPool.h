@@ -0,0 +1,44 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <pthread.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "LockProfile.h"
+
+// Pool fijo de hilos trabajadores. parallelFor() reparte los índices
+// [0, count) entre los trabajadores y el hilo que llama, y regresa cuando
+// todos terminaron. Con 0 trabajadores todo corre en el hilo que llama.
+class WorkerPool {
+private:
+    std::vector<pthread_t> workers;
+
+    ProfiledMutex poolMutex;
+    pthread_cond_t workCondition;       // Hay un trabajo nuevo (o hay que salir)
+    pthread_cond_t doneCondition;       // Un trabajador soltó el trabajo actual
+
+    const std::function<void(int)>* job;
+    int jobCount;
+    std::atomic<int> nextIndex;
+    std::atomic<int> completed;
+    unsigned long generation;           // Cambia con cada trabajo publicado
+    int busyWorkers;
+    bool stopping;
+
+    static void* workerFunc(void* arg);
+    void drainJob(const std::function<void(int)>& fn, int count);
+
+public:
+    explicit WorkerPool(int threadCount);
+    ~WorkerPool();
+
+    void parallelFor(int count, const std::function<void(int)>& fn);
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Tamaño por defecto: pequeño, deja un núcleo al hilo que llama
+    static int defaultSize(int maxWorkers);
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "Entity.h"
+#include "InvaderFormation.h"
+#include "GameEvents.h"
+
+// Estado completo del mundo al final de un tick, todo lo que necesita el
+// renderizado. La simulación lo escribe y el renderizado solo lo lee.
+struct WorldSnapshot {
+    long tick;                  // -1 mientras no se haya publicado nada
+    int width, height;
+    int gameState;
+    int gameMode;
+    int score, lives;
+    bool showPerfOverlay;
+    int wave, waves;
+    GameStats stats;
+    
+    Entity player;
+    FormationView invaders;
+    std::vector<Entity> playerBullets;
+    std::vector<Entity> invaderBullets;
+    
+    // Lo que hace falta del tick anterior para interpolar: la formación y
+    // el jugador son lo único que se mueve más de una celda entre ticks
+    int previousOriginX, previousOriginY;
+    int previousPlayerX;
+    std::chrono::steady_clock::time_point publishedAt;
+    double tickSeconds;
+    
+    WorldSnapshot()
+        : tick(-1), width(0), height(0), gameState(0), gameMode(1),
+          score(0), lives(0), showPerfOverlay(false), wave(1), waves(1),
+          previousOriginX(0), previousOriginY(0), previousPlayerX(0), tickSeconds(1.0 / 60) {}
+};
+
+// Posiciones a dibujar en un punto entre el tick anterior y el publicado
+struct InterpolatedPositions {
+    int originX, originY;
+    int playerX;
+    
+    bool operator==(const InterpolatedPositions& other) const {
+        return originX == other.originX && originY == other.originY && playerX == other.playerX;
+    }
+    bool operator!=(const InterpolatedPositions& other) const { return !(*this == other); }
+};
+
+// alpha = 0 es el tick anterior y 1 el publicado. Solo se interpolan
+// movimientos de más de una celda; una oleada nueva o un reinicio llegan
+// con la posición anterior igual a la nueva y se dibujan de golpe.
+InterpolatedPositions interpolatePositions(const WorldSnapshot& world, double alpha);
+
+// Fracción de tick transcurrida desde que se publicó, en [0, 1]
+double interpolationAlpha(const WorldSnapshot& world, std::chrono::steady_clock::time_point now);
+
+// Primer momento en que el frame dibujado en now puede cambiar: el próximo
+// tick o, interpolando un salto de varias celdas, la próxima celda
+std::chrono::steady_clock::time_point nextFrameChange(const WorldSnapshot& world,
+                                                      std::chrono::steady_clock::time_point now,
+                                                      bool interpolated);
+
+// Triple buffer de instantáneas. La simulación siempre escribe en su
+// propio slot y lo publica intercambiando índices con un atómico; el
+// renderizado toma el último publicado de la misma forma. Nadie espera a
+// nadie: la simulación nunca se detiene por el dibujo y el renderizado
+// siempre lee un frame consistente sin locks.
+class SnapshotBuffer {
+private:
+    static const int FRESH = 4;         // Bit: el slot intermedio es nuevo
+    static const int INDEX_MASK = 3;
+    
+    WorldSnapshot slots[3];
+    int writeIndex;                     // Solo lo toca la simulación
+    int readIndex;                      // Solo lo toca el renderizado
+    std::atomic<int> middle;            // Índice compartido | FRESH
+    
+public:
+    SnapshotBuffer();
+    
+    // Lado de la simulación
+    WorldSnapshot& beginWrite() { return slots[writeIndex]; }
+    void publish();
+    
+    // Lado del renderizado: la instantánea más reciente publicada
+    const WorldSnapshot& acquire();
+};
+
+#endif
@@ -4,13 +4,345 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
 #include "include/GameEngine.h"
+#include "include/ThreadManager.h"
+#include "include/SessionHost.h"
 #include "include/MenuSystem.h"
 #include "include/GameRenderer.h"
+#include "include/ScoreStore.h"
+#include "include/LockProfile.h"
 
 using namespace std;
 
-int main() {
+// Opciones de línea de comandos
+struct GameOptions {
+    bool headless = false;
+    
+    // Modo headless (sin terminal)
+    long ticks = 100000;
+    int width = 80;
+    int height = 24;
+    int mode = 1;
+    bool perf = false;      // Medir tiempos por fase en modo headless
+    
+    int bulletCapacity = BulletPool::DEFAULT_CAPACITY;
+    OutputBackend output = OutputBackend::Curses;
+    double tickRate = 60.0;
+    double renderRate = 30.0;   // 0 = sin límite
+    bool interpolate = true;
+    CatchUpPolicy catchUp = CatchUpPolicy::Skip;
+    
+    // Grabación y reproducción determinista
+    std::string recordPath;
+    std::string replayPath;
+    bool hasSeed = false;
+    uint64_t seed = 0;
+    
+    // Formación (0 = según el modo) y modo de estrés
+    FormationConfig formation;
+    int stressInvaders = 0;
+    
+    // Varias sesiones independientes en un pool de hilos
+    int sessions = 1;
+    int threads = 0;        // 0 = según los núcleos
+    
+    // Puntajes guardados
+    std::string scoresPath;
+    int topScoresMode = -1; // >= 0: imprimir la tabla de ese modo (0 = todos) y salir
+    int topScoresDays = 0;  // > 0: solo partidas de los últimos días
+};
+
+// Archivo de puntajes por defecto: en el home del usuario si se conoce
+static std::string defaultScoresPath() {
+    const char* home = getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.space_invaders_scores";
+    }
+    return ".space_invaders_scores";
+}
+
+// Modo de estrés: unos N invasores en un campo virtual más grande que la
+// terminal, con descargas que mantienen del orden de N proyectiles vivos
+static void applyStress(GameOptions& options) {
+    int n = options.stressInvaders;
+    
+    options.headless = true;
+    options.formation.columns = std::max(8, static_cast<int>(sqrt(n * 4.0)));
+    options.formation.rows = (n + options.formation.columns - 1) / options.formation.columns;
+    options.formation.spacingX = Sprites::invaderWidth();
+    options.formation.spacingY = 2;
+    options.formation.shootersPerVolley = std::max(1, n / 8);
+    options.formation.lives = 1000000;     // Que la carga no se corte por game over
+    
+    options.width = options.formation.columns * options.formation.spacingX + 12;
+    options.height = options.formation.rows * options.formation.spacingY + 40;
+    options.bulletCapacity = std::max(options.bulletCapacity, n);
+}
+
+// Muchas sesiones a la vez: cada una avanza options.ticks ticks y se
+// reporta el total en ticks de sesión por segundo
+int runSessions(const GameOptions& options) {
+    SessionConfig config;
+    config.width = options.width;
+    config.height = options.height;
+    config.mode = options.mode;
+    config.bulletCapacity = options.bulletCapacity;
+    config.formation = options.formation;
+    config.seed = options.hasSeed ? options.seed : 1;
+    
+    int workers = options.threads > 0 ? options.threads - 1 : WorkerPool::defaultSize(1024);
+    SessionHost host(options.sessions, config, workers);
+    
+    auto start = chrono::steady_clock::now();
+    host.run(options.ticks);
+    auto end = chrono::steady_clock::now();
+    
+    double seconds = chrono::duration<double>(end - start).count();
+    double sessionTicks = double(options.ticks) * host.size();
+    
+    cout << "sessions=" << host.size()
+         << " threads=" << host.threads()
+         << " ticks_per_session=" << options.ticks
+         << " field=" << options.width << "x" << options.height
+         << " mode=" << options.mode
+         << " games=" << host.gamesFinished()
+         << " seconds=" << seconds
+         << " session_ticks_per_sec=" << (seconds > 0 ? sessionTicks / seconds : 0)
+         << endl;
+    
+    return 0;
+}
+
+// Corre la simulación sin ncurses tan rápido como permita la CPU.
+// Un piloto automático dispara cada tick y barre la nave de lado a lado
+// encolando comandos, igual que el hilo de entrada en el juego normal, y
+// las partidas terminadas se reinician para mantener la carga constante.
+// Con --sessions N corren N partidas independientes en un pool de hilos.
+int runHeadless(const GameOptions& options) {
+    if (options.sessions > 1) {
+        return runSessions(options);
+    }
+    
+    GameEngine engine(options.width, options.height);
+    engine.setBulletCapacity(options.bulletCapacity);
+    engine.getThreadManager()->getPerfStats().setEnabled(options.perf);
+    if (options.hasSeed) {
+        engine.setSeed(options.seed);
+    }
+    engine.setRecordPath(options.recordPath);
+    engine.setFormationConfig(options.formation);
+    engine.startHeadless(options.mode);
+    
+    long gamesFinished = 0;
+    int sweep = 1;
+    
+    auto start = chrono::steady_clock::now();
+    
+    for (long t = 0; t < options.ticks; t++) {
+        SessionHost::autopilot(engine, sweep, gamesFinished);
+        engine.tick();
+    }
+    
+    auto end = chrono::steady_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+    engine.endRecording();
+    
+    cout << "headless ticks=" << options.ticks
+         << " field=" << options.width << "x" << options.height
+         << " mode=" << options.mode
+         << " games=" << gamesFinished
+         << " invaders=" << engine.getInvaders()->size()
+         << " bullets=" << engine.getPlayerBullets()->size() + engine.getInvaderBullets()->size()
+         << " state=" << engine.getGameState()
+         << " score=" << engine.getPlayer()->score
+         << " lives=" << engine.getPlayer()->lives
+         << " seconds=" << seconds
+         << " ticks_per_sec=" << (seconds > 0 ? options.ticks / seconds : 0)
+         << endl;
+    if (options.perf) {
+        cout << engine.getThreadManager()->getPerfStats().report();
+    }
+    
+    return 0;
+}
+
+// Reproduce una grabación sin terminal y tan rápido como se pueda: cada
+// comando se encola justo antes del tick en que se consumió originalmente.
+// Al final imprime el estado para compararlo con la partida grabada.
+int runReplay(const GameOptions& options) {
+    InputReplay replay;
+    std::string error;
+    if (!replay.load(options.replayPath, error)) {
+        cerr << "Error: " << error << endl;
+        return 1;
+    }
+    
+    const ReplayHeader& header = replay.getHeader();
+    GameEngine engine(header.width, header.height);
+    engine.setBulletCapacity(header.bulletCapacity);
+    engine.getThreadManager()->getPerfStats().setEnabled(options.perf);
+    engine.setSeed(header.seed);
+    engine.setFormationConfig(header.formation);
+    engine.startHeadless(header.mode);
+    
+    CommandQueue& commands = engine.getThreadManager()->getCommandQueue();
+    
+    auto start = chrono::steady_clock::now();
+    
+    // Sin marcador de fin (grabación cortada) se corre hasta el último comando
+    while (replay.getEndTick() >= 0 ? engine.getTickCount() < replay.getEndTick()
+                                    : !replay.finished()) {
+        InputCommand cmd;
+        while (replay.pop(engine.getTickCount(), cmd)) {
+            commands.push(cmd);
+        }
+        engine.tick();
+    }
+    
+    auto end = chrono::steady_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+    long ticks = engine.getTickCount();
+    
+    cout << "replay ticks=" << ticks
+         << " field=" << header.width << "x" << header.height
+         << " mode=" << header.mode
+         << " seed=" << header.seed
+         << " state=" << engine.getGameState()
+         << " score=" << engine.getPlayer()->score
+         << " lives=" << engine.getPlayer()->lives
+         << " seconds=" << seconds
+         << " ticks_per_sec=" << (seconds > 0 ? ticks / seconds : 0)
+         << endl;
+    if (options.perf) {
+        cout << engine.getThreadManager()->getPerfStats().report();
+    }
+    
+    return 0;
+}
+
+// Tabla de mejores puntajes por consola, sin abrir ncurses
+static int runTopScores(const GameOptions& options) {
+    ScoreStore store;
+    if (!store.open(options.scoresPath)) {
+        cerr << "No se pudo abrir " << options.scoresPath << endl;
+        return 1;
+    }
+    
+    std::vector<ScoreRecord> best;
+    if (options.topScoresDays > 0) {
+        int64_t now = static_cast<int64_t>(time(nullptr));
+        best = store.topScoresBetween(options.topScoresMode,
+                                      now - static_cast<int64_t>(options.topScoresDays) * 86400,
+                                      now + 1, 10);
+    } else {
+        best = store.topScores(options.topScoresMode, 10);
+    }
+    
+    cout << "rank,name,score,mode,wave,timestamp" << endl;
+    for (size_t i = 0; i < best.size(); i++) {
+        const ScoreRecord& record = best[i];
+        cout << i + 1 << ','
+             << std::string(record.name, strnlen(record.name, sizeof(record.name))) << ','
+             << record.score << ',' << static_cast<int>(record.mode) << ','
+             << static_cast<int>(record.wave) << ',' << record.timestamp << endl;
+    }
+    cout << "records=" << store.size() << " path=" << store.getPath() << endl;
+    return 0;
+}
+
+// Con make profile: contención de cada lock al salir, en cualquier modo
+static void printLockProfile() {
+    cout << LockProfile::report();
+}
+
+int main(int argc, char* argv[]) {
+    GameOptions options;
+    
+    LockProfile::nameThread("principal");
+    if (LockProfile::enabled()) {
+        atexit(printLockProfile);
+    }
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            options.perf = true;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            options.ticks = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            options.width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            options.height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            options.mode = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bullet-cap") == 0 && i + 1 < argc) {
+            options.bulletCapacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            options.tickRate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--catch-up") == 0 && i + 1 < argc) {
+            options.catchUp = (strcmp(argv[++i], "burst") == 0) ? CatchUpPolicy::Burst
+                                                                 : CatchUpPolicy::Skip;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.hasSeed = true;
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+            options.formation.rows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc) {
+            options.formation.columns = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spacing") == 0 && i + 1 < argc) {
+            options.formation.spacingX = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--waves") == 0 && i + 1 < argc) {
+            options.formation.waves = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            options.sessions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stress") == 0 && i + 1 < argc) {
+            options.stressInvaders = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            options.renderRate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--no-interp") == 0) {
+            options.interpolate = false;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output = (strcmp(argv[++i], "ansi") == 0) ? OutputBackend::Ansi
+                                                                : OutputBackend::Curses;
+        } else if (strcmp(argv[i], "--scores") == 0 && i + 1 < argc) {
+            options.scoresPath = argv[++i];
+        } else if (strcmp(argv[i], "--top-scores") == 0 && i + 1 < argc) {
+            options.topScoresMode = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            options.topScoresDays = atoi(argv[++i]);
+        }
+    }
+    
+    if (options.scoresPath.empty()) {
+        options.scoresPath = defaultScoresPath();
+    }
+    
+    if (options.stressInvaders > 0) {
+        applyStress(options);
+    }
+    
+    if (options.topScoresMode >= 0) {
+        return runTopScores(options);
+    }
+    if (!options.replayPath.empty()) {
+        return runReplay(options);
+    }
+    if (options.headless) {
+        return runHeadless(options);
+    }
+    
     initscr();
     noecho();
     cbreak();
@@ -18,6 +350,10 @@ int main() {
     keypad(stdscr, TRUE);
     curs_set(0);
     
+    // Durante la partida stdin lo lee el hilo de entrada: ncurses no debe
+    // revisarlo para cortar refresh() a medias
+    typeahead(-1);
+    
     // Verificar soporte de colores
     if (has_colors()) {
         start_color();
@@ -28,19 +364,39 @@ int main() {
         init_pair(5, COLOR_MAGENTA, COLOR_BLACK); // Menú
     }
     
+    RenderStats renderTotals{0, 0, 0, 0};
+    OutputBackend outputUsed = OutputBackend::Curses;
+    PacerStats tickStats{};
+    std::string perfReport;
+    
     try {
         // Crear instancias principales
+        // Sin archivo de puntajes se juega igual, solo no se guardan.
+        // Se declara antes que el motor para que lo sobreviva.
+        ScoreStore scores;
         MenuSystem menu;
         GameEngine engine;
         GameRenderer renderer;
+        if (scores.open(options.scoresPath)) {
+            engine.setScoreStore(&scores);
+            menu.setScoreStore(&scores);
+        }
+        engine.setBulletCapacity(options.bulletCapacity);
+        engine.getRenderer()->setBackend(options.output);
+        engine.getThreadManager()->setTickRate(options.tickRate, options.catchUp);
+        engine.getThreadManager()->setRenderRate(options.renderRate);
+        engine.setInterpolation(options.interpolate);
+        engine.setRecordPath(options.recordPath);
+        engine.setFormationConfig(options.formation);
+        if (options.hasSeed) {
+            engine.setSeed(options.seed);
+        }
         
         bool running = true;
         int option;
         
         while (running) {
-            clear();
-            
-            // Mostrar menú principal
+            // Mostrar menú principal (se repinta solo lo que cambió)
             option = menu.showMainMenu();
             
             switch (option) {
@@ -69,6 +425,13 @@ int main() {
             }
         }
         
+        renderTotals = engine.getRenderer()->getTotalStats();
+        outputUsed = engine.getRenderer()->getBackend();
+        tickStats = engine.getThreadManager()->getTickStats();
+        if (tickStats.ticks > 0) {
+            perfReport = engine.getThreadManager()->getPerfStats().report();
+        }
+        
     } catch (const exception& e) {
         endwin();
         cerr << "Error: " << e.what() << endl;
@@ -77,6 +440,28 @@ int main() {
     
     // Finalizar ncurses
     endwin();
+    
+    if (renderTotals.frames > 0) {
+        cout << "render backend=" << (outputUsed == OutputBackend::Ansi ? "ansi" : "curses")
+             << " frames=" << renderTotals.frames
+             << " cells_per_frame=" << renderTotals.cellsWritten / renderTotals.frames
+             << " bytes_per_frame=" << renderTotals.bytesWritten / renderTotals.frames
+             << " syscalls_per_frame=" << static_cast<double>(renderTotals.syscalls) / renderTotals.frames
+             << endl;
+    }
+    
+    if (tickStats.ticks > 0) {
+        cout << "tick target_ms=" << tickStats.targetMs
+             << " mean_ms=" << tickStats.meanMs
+             << " jitter_ms=" << tickStats.jitterMs
+             << " min_ms=" << tickStats.minMs
+             << " max_ms=" << tickStats.maxMs
+             << " missed=" << tickStats.missedDeadlines
+             << " dropped=" << tickStats.droppedTicks
+             << endl;
+        cout << perfReport;
+    }
+    
     cout << "¡Gracias por jugar Space Invaders!" << endl;
     
     return 0;
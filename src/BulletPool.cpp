@@ -0,0 +1,11 @@
+#include "BulletPool.h"
+#include <algorithm>
+
+BulletPool::BulletPool(int capacity) : count(0) {
+    setCapacity(capacity);
+}
+
+void BulletPool::setCapacity(int capacity) {
+    bullets.assign(std::max(1, capacity), Entity());
+    count = 0;
+}
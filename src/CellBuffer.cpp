@@ -0,0 +1,21 @@
+#include "CellBuffer.h"
+#include <algorithm>
+
+CellBuffer::CellBuffer() : width(0), height(0) {
+}
+
+void CellBuffer::resize(int w, int h) {
+    width = std::max(0, w);
+    height = std::max(0, h);
+    cells.assign(width * height, Cell{' ', 0, CELL_NORMAL});
+}
+
+void CellBuffer::fill(const Cell& cell) {
+    std::fill(cells.begin(), cells.end(), cell);
+}
+
+void CellBuffer::text(int x, int y, const std::string& s, int colorPair, int attrs) {
+    for (size_t i = 0; i < s.length(); i++) {
+        put(x + static_cast<int>(i), y, s[i], colorPair, attrs);
+    }
+}
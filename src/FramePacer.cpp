@@ -0,0 +1,79 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer(double hz, CatchUpPolicy policy, int maxBurst)
+    : started(false), uncapped(false), policy(policy), maxBurst(maxBurst),
+      samples(0), mean(0), m2(0), minPeriod(0), maxPeriod(0), missed(0), dropped(0) {
+    setRate(hz);
+}
+
+void FramePacer::setRate(double hz) {
+    if (hz <= 0) hz = 60.0;
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+double FramePacer::getRate() const {
+    return 1.0 / std::chrono::duration<double>(period).count();
+}
+
+void FramePacer::start() {
+    nextDeadline = Clock::now();
+    started = false;
+}
+
+int FramePacer::waitNext() {
+    if (!uncapped) {
+        std::this_thread::sleep_until(nextDeadline);
+    }
+    
+    Clock::time_point now = Clock::now();
+    
+    if (started) {
+        double ms = std::chrono::duration<double, std::milli>(now - lastWake).count();
+        samples++;
+        double delta = ms - mean;
+        mean += delta / samples;
+        m2 += delta * (ms - mean);
+        minPeriod = (samples == 1) ? ms : std::min(minPeriod, ms);
+        maxPeriod = (samples == 1) ? ms : std::max(maxPeriod, ms);
+    }
+    started = true;
+    lastWake = now;
+    
+    if (uncapped) {
+        return 1;
+    }
+    
+    nextDeadline += period;
+    if (now < nextDeadline) {
+        return 1;
+    }
+    
+    // Se perdieron deadlines: cuántos periodos completos quedaron atrás
+    long behind = static_cast<long>((now - nextDeadline) / period) + 1;
+    missed += behind;
+    
+    int extra = 0;
+    if (policy == CatchUpPolicy::Burst) {
+        extra = static_cast<int>(std::min<long>(behind, maxBurst));
+    }
+    
+    dropped += behind - extra;
+    nextDeadline += period * behind;
+    return 1 + extra;
+}
+
+PacerStats FramePacer::getStats() const {
+    PacerStats stats;
+    stats.ticks = samples;
+    stats.targetMs = uncapped ? 0.0 : std::chrono::duration<double, std::milli>(period).count();
+    stats.meanMs = mean;
+    stats.jitterMs = samples > 1 ? std::sqrt(m2 / (samples - 1)) : 0.0;
+    stats.minMs = minPeriod;
+    stats.maxMs = maxPeriod;
+    stats.missedDeadlines = missed;
+    stats.droppedTicks = dropped;
+    return stats;
+}
@@ -1,17 +1,36 @@
 #include "GameEngine.h"
 #include "ThreadManager.h"
+#include "ScoreStore.h"
 #include <chrono>
-#include <thread>
 #include <algorithm>
+#include <cstdlib>
 
 GameEngine::GameEngine() 
-    : renderer(nullptr), threadManager(nullptr), gameMode(1), 
-      gameState(0), running(false), playerShouldShoot(false) {
+    : renderer(nullptr), threadManager(nullptr), currentWave(1), tickCount(0),
+      publishedOriginX(0), publishedOriginY(0), publishedPlayerX(0),
+      interpolate(true), renderedTick(-1), renderedAt{0, 0, 0}, seed(0), fixedSeed(false),
+      scoreStore(nullptr), invaderMoveCounter(0), invaderDirection(1), invaderShootTimer(0), gameMode(1),
+      gameState(0), running(false), playerShouldShoot(false), headless(false),
+      showPerfOverlay(false) {
     getmaxyx(stdscr, screenHeight, screenWidth);
+    sizeEventQueue();
     renderer = new GameRenderer();
     threadManager = new ThreadManager(this);
 }
 
+GameEngine::GameEngine(int width, int height)
+    : renderer(nullptr), threadManager(nullptr), currentWave(1), tickCount(0),
+      publishedOriginX(0), publishedOriginY(0), publishedPlayerX(0),
+      interpolate(true), renderedTick(-1), renderedAt{0, 0, 0}, seed(0), fixedSeed(false),
+      scoreStore(nullptr), invaderMoveCounter(0), invaderDirection(1), invaderShootTimer(0), gameMode(1),
+      screenWidth(width), screenHeight(height),
+      gameState(0), running(false), playerShouldShoot(false), headless(true),
+      showPerfOverlay(false) {
+    // Sin ncurses: no se consulta stdscr ni se crea el renderer
+    sizeEventQueue();
+    threadManager = new ThreadManager(this);
+}
+
 GameEngine::~GameEngine() {
     if (threadManager && threadManager->isRunning()) {
         threadManager->stopThreads();
@@ -27,88 +46,258 @@ void GameEngine::startGame(int mode) {
     playerShouldShoot = false;
     
     initializeGame();
+    beginRecording();
+    
+    // El menú dibujó directo con ncurses: el primer frame se manda completo
+    renderer->invalidate();
+    renderedTick = -1;
+    publishSnapshot();
     
     // Iniciar todos los hilos
     threadManager->startThreads();
     
-    // Bucle principal - ahora solo espera a que running sea false
+    // Bucle principal - duerme hasta que termina una partida (y guarda su
+    // puntaje, fuera del hilo de la simulación) o hasta que running es false
     while (running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        threadManager->waitStateChange();
+        saveFinishedGames();
     }
     
     // Detener hilos cuando se sale del juego
     threadManager->stopThreads();
+    endRecording();
+    saveFinishedGames();
+}
+
+void GameEngine::endGame(int state) {
+    gameState = state;
+    finishedGames.push(FinishedGame{player.score, gameMode, currentWave});
+    threadManager->notifyStateChange();
+}
+
+void GameEngine::saveFinishedGames() {
+    FinishedGame game;
+    while (finishedGames.pop(game)) {
+        if (scoreStore) {
+            const char* user = getenv("USER");
+            scoreStore->append(game.score, game.mode, game.wave, user ? user : "JUGADOR");
+        }
+    }
+}
+
+// Prepara una partida sin hilos ni terminal; el llamador avanza con tick()
+void GameEngine::startHeadless(int mode) {
+    gameMode = mode;
+    running = true;
+    gameState = 0;
+    playerShouldShoot = false;
+    
+    initializeGame();
+    beginRecording();
+}
+
+void GameEngine::tick() {
+    threadManager->runTick();
+}
+
+void GameEngine::setBulletCapacity(int capacity) {
+    playerBullets.setCapacity(capacity);
+    invaderBullets.setCapacity(capacity);
+    sizeEventQueue();
+}
+
+// En un tick caben a lo sumo un disparo, un impacto por bala viva y el fin
+// de la oleada; la fase de puntaje vacía la cola en el mismo tick
+void GameEngine::sizeEventQueue() {
+    events.setCapacity(playerBullets.capacity() + invaderBullets.capacity() + 16);
+}
+
+void GameEngine::seedRandom() {
+    if (!fixedSeed) {
+        seed = static_cast<uint64_t>(
+            std::chrono::system_clock::now().time_since_epoch().count());
+    }
+    random.seed(seed);
+}
+
+// Guarda en la cabecera todo lo que, además de la entrada, decide la partida
+void GameEngine::beginRecording() {
+    if (recordPath.empty()) {
+        return;
+    }
+    
+    ReplayHeader header;
+    header.seed = seed;
+    header.mode = gameMode;
+    header.width = screenWidth;
+    header.height = screenHeight;
+    header.bulletCapacity = playerBullets.capacity();
+    header.formation = formationOverrides;
+    recorder.open(recordPath, header);
 }
 
 void GameEngine::initializeGame() {
-    getmaxyx(stdscr, screenHeight, screenWidth);
+    if (!headless) {
+        getmaxyx(stdscr, screenHeight, screenWidth);
+    }
+    
+    tickCount = 0;
+    seedRandom();
     
     // Inicializar jugador
-    player.lives = 3;
+    player.lives = formationOverrides.resolve(gameMode).lives;
     player.score = 0;
+    stats.reset();
+    events.clear();
     player.entity.x = screenWidth / 2;
     player.entity.y = screenHeight - 3;
     player.entity.symbol = '*';
     player.entity.colorPair = 1;
     player.entity.active = true;
     
-    // Limpiar vectores
+    // Limpiar entidades
     invaders.clear();
     playerBullets.clear();
     invaderBullets.clear();
     
     // Configurar invasores según el modo
+    currentWave = 1;
+    setupInvaders();
+}
+
+// Oleada destruida: llega una formación nueva y se conserva el puntaje
+void GameEngine::nextWave() {
+    currentWave++;
+    playerBullets.clear();
+    invaderBullets.clear();
     setupInvaders();
 }
 
 void GameEngine::setupInvaders() {
     invaders.clear();
-    
-    int invaderCount = (gameMode == 1) ? 40 : 50;
-    int groupSize = (gameMode == 1) ? 8 : 10;
-    int groups = invaderCount / groupSize;
+    formation = formationOverrides.resolve(gameMode);
     
     int startX = 5;
     int startY = 3;
-    int spacing = 3;
     
-    for (int group = 0; group < groups; group++) {
-        for (int i = 0; i < groupSize; i++) {
-            int x = startX + (i * spacing);
-            int y = startY + (group * 2);
-            
-            // Alternar símbolos para variedad visual
-            char symbol = (group % 3 == 0) ? 'W' : ((group % 3 == 1) ? '@' : '^');
+    invaders.setOrigin(startX, startY);
+    
+    for (int row = 0; row < formation.rows; row++) {
+        for (int i = 0; i < formation.columns; i++) {
+            // Desplazamiento relativo al origen de la formación
+            int dx = i * formation.spacingX;
+            int dy = row * formation.spacingY;
             
-            Entity invader(x, y, symbol, 2);
-            invaders.push_back(invader);
+            // Alternar tipos de invasor por fila para variedad visual
+            invaders.add(dx, dy, Sprites::invaderForRow(row));
         }
     }
+    
+    invaders.build();
+    
+    // La formación nueva y la nave recién ubicada aparecen de golpe: la
+    // próxima instantánea no las interpola desde donde estaban
+    publishedOriginX = startX;
+    publishedOriginY = startY;
+    publishedPlayerX = player.entity.x;
+    
+    invaderMoveCounter = 0;
+    invaderDirection = 1;
+    invaderShootTimer = 0;
+}
+
+// Copia el estado del mundo al slot de escritura y lo publica. Lo llama la
+// simulación al final de cada tick; no reserva memoria una vez que los
+// vectores de la instantánea alcanzan su tamaño.
+void GameEngine::publishSnapshot() {
+    WorldSnapshot& world = snapshots.beginWrite();
+    
+    world.tick = tickCount;
+    world.width = screenWidth;
+    world.height = screenHeight;
+    world.gameState = gameState;
+    world.gameMode = gameMode;
+    world.score = player.score;
+    world.lives = player.lives;
+    world.showPerfOverlay = showPerfOverlay;
+    world.wave = currentWave;
+    world.waves = formation.waves;
+    world.stats = stats;
+    world.player = player.entity;
+    
+    invaders.snapshotTo(world.invaders);
+    
+    world.previousOriginX = publishedOriginX;
+    world.previousOriginY = publishedOriginY;
+    world.previousPlayerX = publishedPlayerX;
+    world.publishedAt = std::chrono::steady_clock::now();
+    world.tickSeconds = 1.0 / threadManager->getTickRate();
+    publishedOriginX = world.invaders.originX;
+    publishedOriginY = world.invaders.originY;
+    publishedPlayerX = player.entity.x;
+
+    world.playerBullets.assign(playerBullets.begin(), playerBullets.end());
+    world.invaderBullets.assign(invaderBullets.begin(), invaderBullets.end());
+    
+    snapshots.publish();
 }
 
-void GameEngine::render() {
-    clear();
+// Dibuja la última instantánea publicada en el buffer del renderer y manda
+// a la terminal solo las celdas que cambiaron. No toca el estado vivo de la
+// simulación ni toma sus locks.
+//
+// El renderizado corre a su propio ritmo: entre dos ticks la formación y el
+// jugador se dibujan interpolados entre el tick anterior y el publicado,
+// según cuánto del periodo de tick pasó desde que se publicó.
+bool GameEngine::render() {
+    if (headless) {
+        return false;
+    }
+    
+    const WorldSnapshot& world = snapshots.acquire();
+    if (world.tick < 0) {
+        return false;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    double alpha = interpolate ? interpolationAlpha(world, now) : 1.0;
+    InterpolatedPositions at = interpolatePositions(world, alpha);
+    frameHeldUntil = nextFrameChange(world, now, interpolate);
     
-    if (gameState == 0) { // Jugando
-        renderer->renderGameField(player, invaders, playerBullets, invaderBullets, screenWidth, screenHeight);
-        renderer->renderUI(player.score, player.lives, gameMode);
+    // Mismo tick y mismas posiciones: el frame saldría idéntico
+    if (world.tick == renderedTick && at == renderedAt) {
+        return false;
+    }
+    renderedTick = world.tick;
+    renderedAt = at;
+    
+    renderer->beginFrame(world.width, world.height);
+    
+    if (world.gameState == 0) { // Jugando
+        renderer->renderGameField(world, at);
+        renderer->renderUI(world.score, world.lives, world.gameMode, world.wave, world.waves);
+        
+        if (world.showPerfOverlay) {
+            threadManager->getPerfStats().advanceWindow(std::chrono::steady_clock::now());
+            renderer->renderPerfOverlay(threadManager->getPerfStats());
+        }
         
-    } else if (gameState == 1) { // Pausa
-        showPauseScreen();
+    } else if (world.gameState == 1) { // Pausa
+        showPauseScreen(world);
         
-    } else if (gameState == 2) { // Game Over
-        showGameOverScreen();
+    } else if (world.gameState == 2) { // Game Over
+        showGameOverScreen(world);
         
-    } else if (gameState == 3) { // Victoria
-        showVictoryScreen();
+    } else if (world.gameState == 3) { // Victoria
+        showVictoryScreen(world);
     }
     
-    refresh();
+    renderer->present();
+    return true;
 }
 
-void GameEngine::showPauseScreen() {
-    int centerY = screenHeight / 2;
-    int centerX = screenWidth / 2;
+void GameEngine::showPauseScreen(const WorldSnapshot& world) {
+    int centerY = world.height / 2;
     
     std::vector<std::string> pauseText = {
         "====================================",
@@ -119,38 +308,30 @@ void GameEngine::showPauseScreen() {
         "Presiona Q para salir"
     };
     
-    attron(COLOR_PAIR(4) | A_BOLD);
-    for (size_t i = 0; i < pauseText.size(); i++) {
-        mvprintw(centerY - 4 + i, centerX - pauseText[i].length() / 2, "%s", pauseText[i].c_str());
-    }
-    attroff(COLOR_PAIR(4) | A_BOLD);
+    renderer->renderCenteredText(pauseText, centerY - 4, 4);
 }
 
-void GameEngine::showGameOverScreen() {
-    int centerY = screenHeight / 2;
-    int centerX = screenWidth / 2;
+void GameEngine::showGameOverScreen(const WorldSnapshot& world) {
+    int centerY = world.height / 2;
     
     std::vector<std::string> gameOverText = {
         "====================================",
         "            GAME OVER",
         "====================================",
         "",
-        "Puntuacion final: " + std::to_string(player.score),
+        "Puntuacion final: " + std::to_string(world.score),
+        "Precision: " + std::to_string(world.stats.accuracy()) + "%   Mejor racha: " +
+            std::to_string(world.stats.bestCombo),
         "",
         "Presiona R para reiniciar",
         "Presiona Q para salir al menu"
     };
     
-    attron(COLOR_PAIR(2) | A_BOLD);
-    for (size_t i = 0; i < gameOverText.size(); i++) {
-        mvprintw(centerY - 5 + i, centerX - gameOverText[i].length() / 2, "%s", gameOverText[i].c_str());
-    }
-    attroff(COLOR_PAIR(2) | A_BOLD);
+    renderer->renderCenteredText(gameOverText, centerY - 5, 2);
 }
 
-void GameEngine::showVictoryScreen() {
-    int centerY = screenHeight / 2;
-    int centerX = screenWidth / 2;
+void GameEngine::showVictoryScreen(const WorldSnapshot& world) {
+    int centerY = world.height / 2;
     
     std::vector<std::string> victoryText = {
         "====================================",
@@ -158,17 +339,15 @@ void GameEngine::showVictoryScreen() {
         "====================================",
         "",
         "Has salvado la Tierra!",
-        "Puntuacion final: " + std::to_string(player.score),
+        "Puntuacion final: " + std::to_string(world.score),
+        "Precision: " + std::to_string(world.stats.accuracy()) + "%   Mejor racha: " +
+            std::to_string(world.stats.bestCombo),
         "",
         "Presiona R para jugar de nuevo",
         "Presiona Q para salir al menu"
     };
     
-    attron(COLOR_PAIR(1) | A_BOLD);
-    for (size_t i = 0; i < victoryText.size(); i++) {
-        mvprintw(centerY - 5 + i, centerX - victoryText[i].length() / 2, "%s", victoryText[i].c_str());
-    }
-    attroff(COLOR_PAIR(1) | A_BOLD);
+    renderer->renderCenteredText(victoryText, centerY - 6, 1);
 }
 
 void GameEngine::pauseGame() {
@@ -181,19 +360,22 @@ void GameEngine::resumeGame() {
 
 void GameEngine::resetGame() {
     // Reinicializar jugador
-    player.lives = 3;
+    player.lives = formationOverrides.resolve(gameMode).lives;
     player.score = 0;
+    stats.reset();
+    events.clear();
     player.entity.x = screenWidth / 2;
     player.entity.y = screenHeight - 3;
     player.entity.active = true;
     playerShouldShoot = false;
     
-    // Limpiar vectores
+    // Limpiar entidades
     invaders.clear();
     playerBullets.clear();
     invaderBullets.clear();
     
     // Configurar invasores según el modo
+    currentWave = 1;
     setupInvaders();
     
     // Cambiar estado a jugando
@@ -1,68 +1,312 @@
 #include "GameRenderer.h"
 #include "GameEngine.h"
+#include "PerfStats.h"
+#include "Sprite.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
-GameRenderer::GameRenderer() {
-    // Constructor vacío
+GameRenderer::GameRenderer()
+    : frontValid(false), backend(OutputBackend::Curses), lastFrame{0, 0, 0, 0}, totals{0, 0, 0, 0} {
+    ioFd = open("/proc/self/io", O_RDONLY);
 }
 
 GameRenderer::~GameRenderer() {
-    // Destructor vacío
+    if (ioFd >= 0) {
+        close(ioFd);
+    }
 }
 
-void GameRenderer::drawBorder(int width, int height) {
-    // Borde superior
-    move(0, 0);
-    for (int i = 0; i < width; i++) {
-        addch('=');
+// Colores de frente de cada par, como los define init_pair() en main.cpp
+// (todos sobre fondo negro). El par 0 es el color por defecto.
+static const int PAIR_FOREGROUND[] = { 39, 32, 31, 33, 36, 35 };
+static const int PAIR_COUNT = sizeof(PAIR_FOREGROUND) / sizeof(PAIR_FOREGROUND[0]);
+
+// Secuencia CUP para mover el cursor a (x, y)
+static void appendCursorMove(std::string& out, int x, int y) {
+    char seq[32];
+    int length = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", y + 1, x + 1);
+    out.append(seq, length);
+}
+
+// Secuencia SGR que deja color y atributos como los de la celda
+static void appendStyle(std::string& out, const Cell& cell) {
+    out += "\x1b[0";
+    if (cell.attrs & CELL_BOLD) out += ";1";
+    if (cell.attrs & CELL_REVERSE) out += ";7";
+    if (cell.colorPair > 0 && cell.colorPair < PAIR_COUNT) {
+        out += ';';
+        out += std::to_string(PAIR_FOREGROUND[cell.colorPair]);
+        out += ";40";
+    }
+    out += 'm';
+}
+
+static bool sameStyle(const Cell& a, const Cell& b) {
+    return a.colorPair == b.colorPair && a.attrs == b.attrs;
+}
+
+void GameRenderer::setBackend(OutputBackend requested) {
+    backend = OutputBackend::Curses;
+    if (requested == OutputBackend::Ansi && isatty(STDOUT_FILENO) && has_colors()) {
+        backend = OutputBackend::Ansi;
     }
+    frontValid = false;
+}
+
+void GameRenderer::beginFrame(int width, int height) {
+    if (back.getWidth() != width || back.getHeight() != height) {
+        back.resize(width, height);
+        front.resize(width, height);
+        frontValid = false;
+    }
+    back.clear();
+}
+
+void GameRenderer::present() {
+    lastFrame = RenderStats{1, 0, 0, 0};
     
-    // Borde inferior
-    move(height - 1, 0);
+    if (backend == OutputBackend::Ansi) {
+        presentAnsi();
+    } else {
+        presentCurses();
+    }
+    
+    front.swap(back);
+    
+    totals.frames++;
+    totals.cellsWritten += lastFrame.cellsWritten;
+    totals.bytesWritten += lastFrame.bytesWritten;
+    totals.syscalls += lastFrame.syscalls;
+}
+
+// Contadores de escritura del proceso. Durante la partida el único que
+// escribe es el hilo de renderizado, así que la diferencia alrededor de
+// refresh() es lo que mandó ncurses.
+bool GameRenderer::readWriteCounters(long& bytes, long& syscalls) {
+    if (ioFd < 0) {
+        return false;
+    }
+    
+    char text[512];
+    ssize_t length = pread(ioFd, text, sizeof(text) - 1, 0);
+    if (length <= 0) {
+        return false;
+    }
+    text[length] = '\0';
+    
+    const char* wchar = strstr(text, "wchar:");
+    const char* syscw = strstr(text, "syscw:");
+    if (!wchar || !syscw) {
+        return false;
+    }
+    bytes = atol(wchar + 6);
+    syscalls = atol(syscw + 6);
+    return true;
+}
+
+void GameRenderer::presentCurses() {
+    int width = back.getWidth();
+    int height = back.getHeight();
+    
+    if (!frontValid) {
+        // La terminal puede tener cualquier cosa: se borra y se manda todo
+        clear();
+        front.fill(Cell{'\0', 0, CELL_NORMAL});
+        frontValid = true;
+    }
+    
+    // Sin /proc/self/io los bytes se estiman con la misma codificación
+    // que usa el backend ANSI; si se puede medir, no se arma
+    bool estimate = ioFd < 0;
+    output.clear();
+    
+    int cursorX = -1, cursorY = -1;
+    Cell style{' ', 255, 255};
+    
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const Cell& cell = back.at(x, y);
+            if (cell == front.at(x, y)) continue;
+            
+            if (estimate && (x != cursorX || y != cursorY)) {
+                appendCursorMove(output, x, y);
+            }
+            if (!sameStyle(cell, style)) {
+                attr_t attrs = COLOR_PAIR(cell.colorPair);
+                if (cell.attrs & CELL_BOLD) attrs |= A_BOLD;
+                if (cell.attrs & CELL_REVERSE) attrs |= A_REVERSE;
+                attrset(attrs);
+                if (estimate) {
+                    appendStyle(output, cell);
+                }
+                style = cell;
+            }
+            
+            mvaddch(y, x, cell.ch);
+            if (estimate) {
+                output += cell.ch;
+            }
+            lastFrame.cellsWritten++;
+            cursorX = x + 1;
+            cursorY = y;
+        }
+    }
+    
+    attrset(A_NORMAL);
+    
+    long bytesBefore, syscallsBefore, bytesAfter, syscallsAfter;
+    bool measured = !estimate && readWriteCounters(bytesBefore, syscallsBefore);
+    refresh();
+    measured = measured && readWriteCounters(bytesAfter, syscallsAfter);
+    
+    if (measured) {
+        lastFrame.bytesWritten = bytesAfter - bytesBefore;
+        lastFrame.syscalls = syscallsAfter - syscallsBefore;
+    } else if (estimate) {
+        lastFrame.bytesWritten = output.size();
+        lastFrame.syscalls = output.empty() ? 0 : 1;
+    } else {
+        // /proc/self/io dejó de responder: este frame cuenta un byte por
+        // celda y los siguientes se estiman
+        close(ioFd);
+        ioFd = -1;
+        lastFrame.bytesWritten = lastFrame.cellsWritten;
+        lastFrame.syscalls = lastFrame.cellsWritten > 0 ? 1 : 0;
+    }
+}
+
+// Todo el frame en un buffer contiguo: un CUP por tramo de celdas que
+// cambiaron, un SGR solo cuando cambia el estilo, y huecos cortos dentro
+// de la misma fila se rellenan con las celdas que ya estaban (cuestan un
+// byte cada una, menos que otro CUP). Se manda con un solo write().
+void GameRenderer::presentAnsi() {
+    static const int MAX_GAP = 4;
+    
+    int width = back.getWidth();
+    int height = back.getHeight();
+    
+    output.clear();
+    
+    if (!frontValid) {
+        output += "\x1b[0m\x1b[H\x1b[2J";
+        front.fill(Cell{'\0', 0, CELL_NORMAL});
+        frontValid = true;
+        
+        // ncurses no se entera de lo que se escribe por fuera: al volver al
+        // menú tiene que redibujar todo
+        clearok(curscr, TRUE);
+    }
+    
+    int cursorX = -1, cursorY = -1;
+    Cell style{' ', 255, 255};
+    
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const Cell& cell = back.at(x, y);
+            if (cell == front.at(x, y)) continue;
+            
+            if (y == cursorY && x > cursorX && x - cursorX <= MAX_GAP) {
+                // Unir con el tramo anterior si el hueco no cambia de estilo
+                bool bridge = true;
+                for (int gx = cursorX; gx < x && bridge; gx++) {
+                    bridge = sameStyle(back.at(gx, y), style);
+                }
+                if (bridge) {
+                    for (int gx = cursorX; gx < x; gx++) {
+                        output += back.at(gx, y).ch;
+                    }
+                    cursorX = x;
+                }
+            }
+            
+            if (x != cursorX || y != cursorY) {
+                appendCursorMove(output, x, y);
+            }
+            if (!sameStyle(cell, style)) {
+                appendStyle(output, cell);
+                style = cell;
+            }
+            
+            output += cell.ch;
+            lastFrame.cellsWritten++;
+            cursorX = x + 1;
+            cursorY = y;
+        }
+    }
+    
+    size_t sent = 0;
+    while (sent < output.size()) {
+        ssize_t n = write(STDOUT_FILENO, output.data() + sent, output.size() - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        sent += n;
+        lastFrame.syscalls++;
+    }
+    lastFrame.bytesWritten = sent;
+}
+
+void GameRenderer::drawBorder(int width, int height) {
+    // Borde superior e inferior
     for (int i = 0; i < width; i++) {
-        addch('=');
+        back.put(i, 0, '=');
+        back.put(i, height - 1, '=');
     }
     
     // Bordes laterales
     for (int i = 1; i < height - 1; i++) {
-        mvaddch(i, 0, '|');
-        mvaddch(i, width - 1, '|');
+        back.put(0, i, '|');
+        back.put(width - 1, i, '|');
     }
 }
 
 void GameRenderer::drawEntity(const Entity& entity) {
     if (entity.active) {
-        if (entity.colorPair > 0) {
-            attron(COLOR_PAIR(entity.colorPair));
-        }
-        mvaddch(entity.y, entity.x, entity.symbol);
-        if (entity.colorPair > 0) {
-            attroff(COLOR_PAIR(entity.colorPair));
+        back.put(entity.x, entity.y, entity.symbol, entity.colorPair);
+    }
+}
+
+// Solo las celdas sólidas: los espacios del sprite dejan ver el fondo
+void GameRenderer::drawSprite(const Sprite& sprite, int frame, int x, int y, int colorPair) {
+    int left = x - sprite.left();
+    int top = y - sprite.above();
+    
+    for (int row = 0; row < sprite.getHeight(); row++) {
+        uint16_t mask = sprite.rowMask(frame, row);
+        for (int column = 0; mask != 0; column++, mask >>= 1) {
+            if (mask & 1) {
+                back.put(left + column, top + row, sprite.glyph(frame, row, column), colorPair);
+            }
         }
     }
 }
 
 void GameRenderer::drawBackground() {
     // Dibujar algunas estrellas en el fondo para ambiente espacial
-    attron(COLOR_PAIR(4));
-    
-    static int starPositions[][2] = {
+    static const int starPositions[][2] = {
         {10, 5}, {25, 8}, {45, 3}, {60, 12}, {75, 6},
         {15, 15}, {35, 18}, {55, 20}, {70, 16}, {80, 22},
         {5, 25}, {30, 28}, {50, 30}, {65, 27}, {85, 25}
     };
     
     for (int i = 0; i < 15; i++) {
-        mvaddch(starPositions[i][1], starPositions[i][0], '.');
+        back.put(starPositions[i][0], starPositions[i][1], '.', 4);
     }
-    
-    attroff(COLOR_PAIR(4));
 }
 
-void GameRenderer::renderGameField(const Player& player, 
-                                  const std::vector<Entity>& invaders,
-                                  const std::vector<Entity>& playerBullets,
-                                  const std::vector<Entity>& invaderBullets,
-                                  int screenWidth, int screenHeight) {
+void GameRenderer::renderGameField(const WorldSnapshot& world) {
+    renderGameField(world, interpolatePositions(world, 1.0));
+}
+
+void GameRenderer::renderGameField(const WorldSnapshot& world, const InterpolatedPositions& at) {
+    int screenWidth = world.width;
+    int screenHeight = world.height;
+    const FormationView& invaders = world.invaders;
+    int shiftX = at.originX - invaders.originX;
+    int shiftY = at.originY - invaders.originY;
     
     // Dibujar borde del campo de juego
     drawBorder(screenWidth, screenHeight);
@@ -71,65 +315,98 @@ void GameRenderer::renderGameField(const Player& player,
     drawBackground();
     
     // Dibujar jugador
-    drawEntity(player.entity);
+    const Entity& player = world.player;
+    if (player.active) {
+        drawSprite(Sprites::get(SPRITE_PLAYER), Sprites::playerFrame(world.tick),
+                   at.playerX, player.y, player.colorPair);
+    }
     
     // Dibujar invasores activos
-    for (const auto& invader : invaders) {
-        if (invader.active) {
-            drawEntity(invader);
+    for (int i = 0; i < invaders.size(); i++) {
+        if (invaders.isActive(i)) {
+            drawSprite(Sprites::get(invaders.sprite(i)), invaders.frame,
+                       invaders.x(i) + shiftX, invaders.y(i) + shiftY, InvaderFormation::COLOR_PAIR_ID);
         }
     }
     
     // Dibujar proyectiles del jugador
-    for (const auto& bullet : playerBullets) {
+    for (const auto& bullet : world.playerBullets) {
         drawEntity(bullet);
     }
     
     // Dibujar proyectiles de invasores
-    for (const auto& bullet : invaderBullets) {
+    for (const auto& bullet : world.invaderBullets) {
         drawEntity(bullet);
     }
     
     // Línea de separación para el área de juego
-    attron(COLOR_PAIR(4));
     for (int i = 1; i < screenWidth - 1; i++) {
-        mvaddch(screenHeight - 5, i, '-');
+        back.put(i, screenHeight - 5, '-', 4);
     }
-    attroff(COLOR_PAIR(4));
 }
 
-void GameRenderer::renderUI(int score, int lives, int gameMode) {
-    int screenWidth, screenHeight;
-    getmaxyx(stdscr, screenHeight, screenWidth);
+void GameRenderer::renderUI(int score, int lives, int gameMode, int wave, int waves) {
+    int screenWidth = back.getWidth();
+    int screenHeight = back.getHeight();
     
     // Área de información del juego
     int uiY = screenHeight - 4;
     
-    attron(COLOR_PAIR(4) | A_BOLD);
-    
     // Mostrar puntuación
-    mvprintw(uiY, 2, "PUNTOS: %d", score);
+    back.text(2, uiY, "PUNTOS: " + std::to_string(score), 4, CELL_BOLD);
     
     // Mostrar vidas
-    mvprintw(uiY + 1, 2, "VIDAS: ");
-    attroff(A_BOLD);
-    
-    attron(COLOR_PAIR(1));
+    back.text(2, uiY + 1, "VIDAS: ", 4, CELL_BOLD);
     for (int i = 0; i < lives; i++) {
-        mvaddch(uiY + 1, 9 + i * 2, '*');
+        back.put(9 + i * 2, uiY + 1, '*', 1);
     }
-    attroff(COLOR_PAIR(1));
     
     // Mostrar modo de juego
-    attron(COLOR_PAIR(4) | A_BOLD);
-    mvprintw(uiY, screenWidth - 15, "MODO: %d", gameMode);
+    back.text(screenWidth - 15, uiY, "MODO: " + std::to_string(gameMode), 4, CELL_BOLD);
+    
+    // Mostrar oleada (solo si hay más de una)
+    if (waves > 1) {
+        back.text(screenWidth - 35, uiY, "OLEADA: " + std::to_string(wave) + "/" + std::to_string(waves), 4, CELL_BOLD);
+    }
     
     // Mostrar controles básicos
-    attron(COLOR_PAIR(4));
-    mvprintw(uiY + 1, screenWidth - 25, "A/D:Mover W:Disparar P:Pausa");
+    back.text(screenWidth - 25, uiY + 1, "A/D:Mover W:Disparar P:Pausa", 4, CELL_BOLD);
+}
+
+// Recuadro en la esquina superior derecha con p50/p99/max en vivo del
+// tick, del renderizado y de la espera de locks (se alterna con T)
+void GameRenderer::renderPerfOverlay(const PerfStats& stats) {
+    static const PerfStats::Phase rows[] = {
+        PerfStats::TICK, PerfStats::RENDER, PerfStats::ENTITY_LOCK_WAIT,
+        PerfStats::INVADERS, PerfStats::BULLETS, PerfStats::COLLISION
+    };
+    static const char* labels[] = { "tick", "render", "lock", "invad", "bullet", "collis" };
+    const int rowCount = 6;
+    const int boxWidth = 30;
+    
+    int x = back.getWidth() - boxWidth - 2;
+    int y = 1;
+    
+    back.text(x, y, "PERF 1s     p50    p99    max", 3, CELL_BOLD);
     
-    attroff(COLOR_PAIR(4) | A_BOLD);
-    attroff(COLOR_PAIR(4));
+    for (int i = 0; i < rowCount; i++) {
+        const LatencyHistogram& h = stats.recent(rows[i]);
+        char line[64];
+        snprintf(line, sizeof(line), "%-7s %7s%7s%7s", labels[i],
+                 formatDuration(h.percentile(50)).c_str(),
+                 formatDuration(h.percentile(99)).c_str(),
+                 formatDuration(h.max()).c_str());
+        back.text(x, y + 1 + i, line, 3);
+    }
+}
+
+// Texto centrado horizontalmente (pantallas de pausa, game over, victoria)
+void GameRenderer::renderCenteredText(const std::vector<std::string>& lines, int startY, int colorPair) {
+    int centerX = back.getWidth() / 2;
+    
+    for (size_t i = 0; i < lines.size(); i++) {
+        back.text(centerX - lines[i].length() / 2, startY + i, lines[i], colorPair, CELL_BOLD);
+    }
 }
 
 void GameRenderer::renderStartScreen() {
@@ -162,4 +439,5 @@ void GameRenderer::renderStartScreen() {
 
 void GameRenderer::clearScreen() {
     clear();
+    frontValid = false;
 }
\ No newline at end of file
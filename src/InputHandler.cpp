@@ -0,0 +1,169 @@
+#include "InputHandler.h"
+#include "LockProfile.h"
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+
+// Tiempo para distinguir un ESC suelto del inicio de una flecha
+static const int ESCAPE_TIMEOUT_MS = 25;
+
+// Más larga que esto, una secuencia sin byte final no es una tecla
+static const int MAX_SEQUENCE = 16;
+
+InputHandler::InputHandler(CommandQueue& q, int fd)
+    : inputFd(fd), running(false), queue(q), notify(nullptr), notifyArg(nullptr) {
+    wakePipe[0] = wakePipe[1] = -1;
+}
+
+InputHandler::~InputHandler() {
+    if (running) {
+        stop();
+    }
+}
+
+void InputHandler::start() {
+    if (pipe(wakePipe) != 0) {
+        wakePipe[0] = wakePipe[1] = -1;
+    }
+    running = true;
+    pthread_create(&thread, nullptr, inputFunc, this);
+}
+
+void InputHandler::stop() {
+    running = false;
+    
+    if (wakePipe[1] >= 0) {
+        char byte = 0;
+        ssize_t ignored = write(wakePipe[1], &byte, 1);
+        (void)ignored;
+    }
+    
+    pthread_join(thread, nullptr);
+    
+    if (wakePipe[0] >= 0) close(wakePipe[0]);
+    if (wakePipe[1] >= 0) close(wakePipe[1]);
+    wakePipe[0] = wakePipe[1] = -1;
+}
+
+void* InputHandler::inputFunc(void* arg) {
+    LockProfile::nameThread("entrada");
+    static_cast<InputHandler*>(arg)->loop();
+    return nullptr;
+}
+
+int InputHandler::decode(const unsigned char* bytes, int length,
+                         InputCommand* out, int maxOut, int* pendingFrom) {
+    int count = 0;
+    *pendingFrom = -1;
+    
+    for (int i = 0; i < length && count < maxOut; i++) {
+        InputCommand cmd = CMD_NONE;
+        
+        switch (bytes[i]) {
+            case 'a': case 'A': cmd = CMD_LEFT; break;
+            case 'd': case 'D': cmd = CMD_RIGHT; break;
+            case 'w': case 'W': case ' ': cmd = CMD_FIRE; break;
+            case 'p': case 'P': cmd = CMD_PAUSE; break;
+            case 'q': case 'Q': cmd = CMD_QUIT; break;
+            case 'r': case 'R': cmd = CMD_RESTART; break;
+            case 't': case 'T': cmd = CMD_TOGGLE_PERF; break;
+            
+            case 27: { // ESC o secuencia de flecha (ESC [ C / ESC O D ...)
+                if (i + 1 >= length) {
+                    *pendingFrom = i;
+                    return count;
+                }
+                if (bytes[i + 1] != '[' && bytes[i + 1] != 'O') {
+                    cmd = CMD_QUIT;
+                    break;
+                }
+                
+                // ESC O lleva un solo byte más. ESC [ (CSI) puede llevar
+                // parámetros antes del byte final (0x40-0x7E): ESC[1;5D es
+                // ctrl+izquierda. Solo cuenta el final, y la secuencia se
+                // consume entera para que sus bytes no se lean como teclas.
+                int end = i + 2;
+                if (bytes[i + 1] == '[') {
+                    while (end < length && (bytes[end] < 0x40 || bytes[end] > 0x7E)) {
+                        end++;
+                    }
+                }
+                if (end >= length) {
+                    if (length - i < MAX_SEQUENCE) {
+                        *pendingFrom = i;
+                        return count;
+                    }
+                    // Demasiado larga para ser una tecla: se descarta
+                    i = length;
+                    break;
+                }
+                if (bytes[end] == 'D') cmd = CMD_LEFT;
+                if (bytes[end] == 'C') cmd = CMD_RIGHT;
+                i = end;
+                break;
+            }
+        }
+        
+        if (cmd != CMD_NONE) {
+            out[count++] = cmd;
+        }
+    }
+    
+    return count;
+}
+
+void InputHandler::loop() {
+    unsigned char buffer[256];
+    int carry = 0;          // Bytes de una secuencia de escape incompleta
+    
+    while (running) {
+        struct pollfd fds[2];
+        fds[0].fd = inputFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakePipe[0];
+        fds[1].events = POLLIN;
+        
+        int ready = poll(fds, wakePipe[0] >= 0 ? 2 : 1, carry > 0 ? ESCAPE_TIMEOUT_MS : -1);
+        
+        if (ready == 0) {
+            // No llegó el resto de la secuencia: era un ESC suelto
+            queue.push(CMD_QUIT);
+            if (notify) notify(notifyArg);
+            carry = 0;
+            continue;
+        }
+        if (ready < 0 || !running || (wakePipe[0] >= 0 && fds[1].revents)) {
+            continue;
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+        
+        ssize_t n = read(inputFd, buffer + carry, sizeof(buffer) - carry);
+        if (n <= 0) {
+            continue;
+        }
+        int length = carry + static_cast<int>(n);
+        
+        InputCommand commands[256];
+        int pending;
+        int count = decode(buffer, length, commands, 256, &pending);
+        for (int i = 0; i < count; i++) {
+            // Con la cola llena se pierden teclas en vez de acumular retraso
+            queue.push(commands[i]);
+        }
+        if (count > 0 && notify) {
+            notify(notifyArg);
+        }
+        
+        carry = 0;
+        if (pending >= 0) {
+            // Guardar la secuencia incompleta para completarla con la próxima lectura
+            carry = length - pending;
+            memmove(buffer, buffer + pending, carry);
+        }
+    }
+}
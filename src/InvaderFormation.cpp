@@ -0,0 +1,166 @@
+#include "InvaderFormation.h"
+#include <algorithm>
+
+FormationConfig FormationConfig::resolve(int mode) const {
+    FormationConfig resolved = *this;
+    if (resolved.rows <= 0) resolved.rows = 5;
+    if (resolved.columns <= 0) resolved.columns = (mode == 1) ? 8 : 10;
+    if (resolved.spacingX <= 0) resolved.spacingX = 4;
+    if (resolved.spacingY <= 0) resolved.spacingY = 2;
+    // Menos separación que el sprite encimaría a los invasores
+    resolved.spacingX = std::max(resolved.spacingX, Sprites::invaderWidth());
+    resolved.spacingY = std::max(resolved.spacingY, Sprites::invaderHeight());
+    resolved.waves = std::max(1, resolved.waves);
+    resolved.shootersPerVolley = std::max(1, resolved.shootersPerVolley);
+    if (resolved.lives <= 0) resolved.lives = 3;
+    return resolved;
+}
+
+InvaderFormation::InvaderFormation()
+    : originX(0), originY(0), frame(0), layout(std::make_shared<FormationLayout>()), count(0),
+      gridWidth(0), gridHeight(0), coverWidth(0), coverHeight(0),
+      extentLeft(0), extentRight(0), extentAbove(0), extentBelow(0),
+      minColumn(0), maxColumn(-1), minRow(0), maxRow(-1) {
+}
+
+void InvaderFormation::clear() {
+    originX = originY = 0;
+    frame = 0;
+    // Layout nuevo: el anterior puede seguir en uso por una instantánea
+    layout = std::make_shared<FormationLayout>();
+    activeMask.clear();
+    count = 0;
+
+    coverGrid.clear();
+    liveInColumn.clear();
+    liveInRow.clear();
+    liveList.clear();
+    livePosition.clear();
+    gridWidth = gridHeight = 0;
+    coverWidth = coverHeight = 0;
+    extentLeft = extentRight = extentAbove = extentBelow = 0;
+    minColumn = minRow = 0;
+    maxColumn = maxRow = -1;
+}
+
+void InvaderFormation::add(int dx, int dy, SpriteId sprite) {
+    if ((count & 63) == 0) {
+        activeMask.push_back(0);
+    }
+
+    layout->offsetX.push_back(dx);
+    layout->offsetY.push_back(dy);
+    layout->sprites.push_back(sprite);
+    activeMask[count >> 6] |= uint64_t(1) << (count & 63);
+    count++;
+}
+
+// Arma las rejillas locales y los conteos por columna/fila. Los
+// desplazamientos deben ser no negativos (el origen es el ancla del invasor
+// de arriba a la izquierda). Si dos sprites se enciman, la celda queda del
+// último: la separación mínima de FormationConfig lo evita.
+void InvaderFormation::build() {
+    const std::vector<int>& offsetX = layout->offsetX;
+    const std::vector<int>& offsetY = layout->offsetY;
+    
+    gridWidth = 0;
+    gridHeight = 0;
+    extentLeft = extentRight = extentAbove = extentBelow = 0;
+    for (int i = 0; i < count; i++) {
+        const Sprite& s = Sprites::get(layout->sprites[i]);
+        gridWidth = std::max(gridWidth, offsetX[i] + 1);
+        gridHeight = std::max(gridHeight, offsetY[i] + 1);
+        extentLeft = std::max(extentLeft, s.left());
+        extentRight = std::max(extentRight, s.right());
+        extentAbove = std::max(extentAbove, s.above());
+        extentBelow = std::max(extentBelow, s.below());
+    }
+
+    coverWidth = gridWidth + extentLeft + extentRight;
+    coverHeight = gridHeight + extentAbove + extentBelow;
+    coverGrid.assign(coverWidth * coverHeight, -1);
+    for (int i = 0; i < count; i++) {
+        const Sprite& s = Sprites::get(layout->sprites[i]);
+        int left = offsetX[i] + extentLeft - s.left();
+        int top = offsetY[i] + extentAbove - s.above();
+        for (int row = 0; row < s.getHeight(); row++) {
+            for (int column = 0; column < s.getWidth(); column++) {
+                coverGrid[(top + row) * coverWidth + left + column] = i;
+            }
+        }
+    }
+
+    liveInColumn.assign(gridWidth, 0);
+    liveInRow.assign(gridHeight, 0);
+    liveList.clear();
+    livePosition.assign(count, -1);
+
+    for (int i = 0; i < count; i++) {
+        if (!isActive(i)) continue;
+        liveInColumn[offsetX[i]]++;
+        liveInRow[offsetY[i]]++;
+        livePosition[i] = static_cast<int>(liveList.size());
+        liveList.push_back(i);
+    }
+
+    minColumn = 0;
+    maxColumn = gridWidth - 1;
+    while (minColumn <= maxColumn && liveInColumn[minColumn] == 0) minColumn++;
+    while (maxColumn >= minColumn && liveInColumn[maxColumn] == 0) maxColumn--;
+
+    minRow = 0;
+    maxRow = gridHeight - 1;
+    while (minRow <= maxRow && liveInRow[minRow] == 0) minRow++;
+    while (maxRow >= minRow && liveInRow[maxRow] == 0) maxRow--;
+}
+
+// Los extremos solo avanzan hacia adentro, así que a lo largo de una
+// partida el costo total de moverlos está acotado por el ancho y alto de
+// la formación: O(1) amortizado por muerte.
+void InvaderFormation::kill(int i) {
+    if (!isActive(i)) return;
+
+    activeMask[i >> 6] &= ~(uint64_t(1) << (i & 63));
+
+    int column = layout->offsetX[i];
+    int row = layout->offsetY[i];
+    liveInColumn[column]--;
+    liveInRow[row]--;
+
+    int position = livePosition[i];
+    int last = liveList.back();
+    liveList[position] = last;
+    livePosition[last] = position;
+    liveList.pop_back();
+    livePosition[i] = -1;
+
+    while (minColumn <= maxColumn && liveInColumn[minColumn] == 0) minColumn++;
+    while (maxColumn >= minColumn && liveInColumn[maxColumn] == 0) maxColumn--;
+    while (minRow <= maxRow && liveInRow[minRow] == 0) minRow++;
+    while (maxRow >= minRow && liveInRow[maxRow] == 0) maxRow--;
+}
+
+int InvaderFormation::at(int x, int y) const {
+    int column = x - originX + extentLeft;
+    int row = y - originY + extentAbove;
+    if (column < 0 || row < 0 || column >= coverWidth || row >= coverHeight) {
+        return -1;
+    }
+    
+    int index = coverGrid[row * coverWidth + column];
+    if (index < 0 || !isActive(index)) {
+        return -1;
+    }
+    
+    const Sprite& s = Sprites::get(layout->sprites[index]);
+    return s.hits(frame, x - this->x(index), y - this->y(index)) ? index : -1;
+}
+
+void InvaderFormation::snapshotTo(FormationView& view) const {
+    view.layout = layout;
+    view.originX = originX;
+    view.originY = originY;
+    view.frame = frame;
+    view.activeMask.assign(activeMask.begin(), activeMask.end());
+    view.count = count;
+}
@@ -0,0 +1,291 @@
+#include "LockProfile.h"
+#include "PerfStats.h"
+#include <cstring>
+
+#ifdef LOCK_PROFILE
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#endif
+
+// El kernel acepta hasta 15 caracteres; uno más largo queda sin nombre
+static void setSystemThreadName(const char* name) {
+    if (strlen(name) < 16) {
+        pthread_setname_np(pthread_self(), name);
+    }
+}
+
+#ifndef LOCK_PROFILE
+
+bool LockProfile::enabled() { return false; }
+void LockProfile::nameThread(const char* name) { setSystemThreadName(name); }
+std::string LockProfile::report() { return std::string(); }
+
+ProfiledMutex::ProfiledMutex(const char*) { pthread_mutex_init(&mutex, nullptr); }
+ProfiledMutex::~ProfiledMutex() { pthread_mutex_destroy(&mutex); }
+
+#else
+
+static const int MAX_THREADS = 16;     // Nombres de hilo distintos (el último junta al resto)
+static const int MAX_LOCKS = 32;       // Nombres de lock distintos
+
+static const char* threadNames[MAX_THREADS];
+static std::atomic<int> threadNameCount(0);
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static thread_local int threadSlot = -1;
+
+static const std::chrono::steady_clock::time_point profileStart = std::chrono::steady_clock::now();
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profileStart).count();
+}
+
+static void updateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+// Slot del nombre dado; los nombres se comparan por contenido
+static int slotForName(const char* name) {
+    pthread_mutex_lock(&registryMutex);
+    int count = threadNameCount.load(std::memory_order_relaxed);
+    int slot = 0;
+    while (slot < count && strcmp(threadNames[slot], name) != 0) {
+        slot++;
+    }
+    if (slot == count) {
+        if (count < MAX_THREADS - 1) {
+            threadNames[slot] = name;
+            threadNameCount.store(count + 1, std::memory_order_release);
+        } else {
+            slot = MAX_THREADS - 1;
+            threadNames[slot] = "(otros)";
+            threadNameCount.store(MAX_THREADS, std::memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&registryMutex);
+    return slot;
+}
+
+// Hilos que nunca se nombraron (no deberían quedar) suman juntos
+static int currentSlot() {
+    if (threadSlot < 0) {
+        threadSlot = slotForName("sin nombre");
+    }
+    return threadSlot;
+}
+
+struct LockRecord {
+    // Contadores del lock tomado desde un hilo. Son atómicos porque varios
+    // motores pueden sumar a la misma fila desde hilos distintos.
+    struct ThreadCounters {
+        std::atomic<uint64_t> acquisitions;
+        std::atomic<uint64_t> contended;
+        std::atomic<uint64_t> waitNs;
+        std::atomic<uint64_t> maxWaitNs;
+        std::atomic<uint64_t> holdNs;
+        std::atomic<uint64_t> maxHoldNs;
+    };
+
+    const char* name;
+    ThreadCounters perThread[MAX_THREADS];
+
+    void acquired(int slot, uint64_t waitNs, bool contended) {
+        ThreadCounters& counters = perThread[slot];
+        counters.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (contended) {
+            counters.contended.fetch_add(1, std::memory_order_relaxed);
+            counters.waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+            updateMax(counters.maxWaitNs, waitNs);
+        }
+    }
+
+    void released(int slot, uint64_t holdNs) {
+        ThreadCounters& counters = perThread[slot];
+        counters.holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+        updateMax(counters.maxHoldNs, holdNs);
+    }
+};
+
+static LockRecord lockRecords[MAX_LOCKS];
+static int lockRecordCount = 0;
+
+// Registro del nombre dado; sin lugar, los locks nuevos suman en el último
+static LockRecord* recordFor(const char* name) {
+    pthread_mutex_lock(&registryMutex);
+    int index = 0;
+    while (index < lockRecordCount && strcmp(lockRecords[index].name, name) != 0) {
+        index++;
+    }
+    if (index == lockRecordCount) {
+        if (lockRecordCount < MAX_LOCKS - 1) {
+            lockRecordCount++;
+        } else {
+            index = MAX_LOCKS - 1;
+            name = "(otros)";
+            lockRecordCount = MAX_LOCKS;
+        }
+        lockRecords[index].name = name;
+    }
+    pthread_mutex_unlock(&registryMutex);
+    return &lockRecords[index];
+}
+
+bool LockProfile::enabled() { return true; }
+
+void LockProfile::nameThread(const char* name) {
+    setSystemThreadName(name);
+    threadSlot = slotForName(name);
+}
+
+// ===== Mutex =====
+
+ProfiledMutex::ProfiledMutex(const char* name)
+    : record(recordFor(name)), acquiredAt(0), holder(0) {
+    pthread_mutex_init(&mutex, nullptr);
+}
+
+ProfiledMutex::~ProfiledMutex() {
+    pthread_mutex_destroy(&mutex);
+}
+
+// Primero un intento sin esperar: si sale, no hubo contención y no se lee
+// el reloj para medir la espera
+void ProfiledMutex::lock() {
+    int slot = currentSlot();
+    if (pthread_mutex_trylock(&mutex) == 0) {
+        acquired(slot, 0, false);
+        return;
+    }
+
+    uint64_t start = nowNs();
+    pthread_mutex_lock(&mutex);
+    acquired(slot, nowNs() - start, true);
+}
+
+void ProfiledMutex::unlock() {
+    releasing();
+    pthread_mutex_unlock(&mutex);
+}
+
+void ProfiledMutex::wait(pthread_cond_t* condition) {
+    releasing();
+    pthread_cond_wait(condition, &mutex);
+    holder = currentSlot();
+    acquiredAt = nowNs();
+}
+
+void ProfiledMutex::acquired(int slot, uint64_t waitNs, bool contended) {
+    record->acquired(slot, waitNs, contended);
+    holder = slot;
+    acquiredAt = nowNs();
+}
+
+void ProfiledMutex::releasing() {
+    record->released(holder, nowNs() - acquiredAt);
+}
+
+// ===== Reporte =====
+
+struct ReportRow {
+    const char* lock;
+    const char* thread;         // nullptr: total del lock
+    uint64_t acquisitions, contended;
+    uint64_t waitNs, maxWaitNs;
+    uint64_t holdNs, maxHoldNs;
+};
+
+static void addTo(ReportRow& total, const ReportRow& row) {
+    total.acquisitions += row.acquisitions;
+    total.contended += row.contended;
+    total.waitNs += row.waitNs;
+    total.holdNs += row.holdNs;
+    total.maxWaitNs = std::max(total.maxWaitNs, row.maxWaitNs);
+    total.maxHoldNs = std::max(total.maxHoldNs, row.maxHoldNs);
+}
+
+static bool moreSerializing(const ReportRow& a, const ReportRow& b) {
+    if (a.waitNs != b.waitNs) return a.waitNs > b.waitNs;
+    return a.holdNs > b.holdNs;
+}
+
+static void appendRow(std::string& out, const ReportRow& row, uint64_t elapsedNs) {
+    char line[192];
+    double contendedPct = row.acquisitions > 0 ? 100.0 * row.contended / row.acquisitions : 0;
+    double heldPct = elapsedNs > 0 ? 100.0 * row.holdNs / elapsedNs : 0;
+    snprintf(line, sizeof(line), "%-18s %-12s %10llu %6.1f%% %10s %10s %10s %10s %6.1f%%\n",
+             row.lock, row.thread ? row.thread : "(todos)",
+             static_cast<unsigned long long>(row.acquisitions), contendedPct,
+             formatDuration(row.waitNs).c_str(), formatDuration(row.maxWaitNs).c_str(),
+             formatDuration(row.holdNs).c_str(), formatDuration(row.maxHoldNs).c_str(),
+             heldPct);
+    out += line;
+}
+
+// Primero un total por lock y después cada lock por hilo, los dos
+// ordenados por espera total y, a igual espera, por tiempo retenido. El
+// porcentaje retenido es sobre el tiempo desde que arrancó el programa.
+std::string LockProfile::report() {
+    uint64_t elapsedNs = nowNs();
+
+    pthread_mutex_lock(&registryMutex);
+    int locks = lockRecordCount;
+    int threads = threadNameCount.load(std::memory_order_acquire);
+    pthread_mutex_unlock(&registryMutex);
+
+    std::vector<ReportRow> totals;
+    std::vector<ReportRow> rows;
+
+    for (int l = 0; l < locks; l++) {
+        const LockRecord& record = lockRecords[l];
+        ReportRow total = {record.name, nullptr, 0, 0, 0, 0, 0, 0};
+
+        for (int t = 0; t < threads; t++) {
+            const LockRecord::ThreadCounters& counters = record.perThread[t];
+            ReportRow row = {
+                record.name, threadNames[t],
+                counters.acquisitions.load(std::memory_order_relaxed),
+                counters.contended.load(std::memory_order_relaxed),
+                counters.waitNs.load(std::memory_order_relaxed),
+                counters.maxWaitNs.load(std::memory_order_relaxed),
+                counters.holdNs.load(std::memory_order_relaxed),
+                counters.maxHoldNs.load(std::memory_order_relaxed)
+            };
+            if (row.acquisitions == 0) {
+                continue;
+            }
+            addTo(total, row);
+            rows.push_back(row);
+        }
+
+        if (total.acquisitions > 0) {
+            totals.push_back(total);
+        }
+    }
+
+    std::sort(totals.begin(), totals.end(), moreSerializing);
+    std::sort(rows.begin(), rows.end(), moreSerializing);
+
+    char header[192];
+    snprintf(header, sizeof(header), "%-18s %-12s %10s %7s %10s %10s %10s %10s %7s\n",
+             "lock", "hilo", "acquires", "contend", "wait", "wait_max", "hold", "hold_max", "held");
+
+    std::string out = "locks (por espera total)\n";
+    out += header;
+    for (const ReportRow& row : totals) {
+        appendRow(out, row, elapsedNs);
+    }
+    out += "\nlocks por hilo\n";
+    out += header;
+    for (const ReportRow& row : rows) {
+        appendRow(out, row, elapsedNs);
+    }
+    return out;
+}
+
+#endif
@@ -1,8 +1,12 @@
 #include "MenuSystem.h"
-#include <chrono>
-#include <thread>
+#include "ScoreStore.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 
-MenuSystem::MenuSystem() : selectedOption(0) {
+MenuSystem::MenuSystem()
+    : selectedOption(0), scoreStore(nullptr),
+      menuPad(nullptr), instructionsPad(nullptr), scoresPad(nullptr), scoresPadRecords(0) {
     getmaxyx(stdscr, screenHeight, screenWidth);
     
     mainMenuOptions = {
@@ -15,30 +19,30 @@ MenuSystem::MenuSystem() : selectedOption(0) {
 }
 
 MenuSystem::~MenuSystem() {
-    // Destructor vacío
+    freePads();
 }
 
-void MenuSystem::drawBorder() {
+void MenuSystem::drawBorder(WINDOW* win) {
     // Dibujar borde superior
-    move(0, 0);
+    wmove(win, 0, 0);
     for (int i = 0; i < screenWidth; i++) {
-        addch('=');
+        waddch(win, '=');
     }
     
     // Dibujar borde inferior
-    move(screenHeight - 1, 0);
+    wmove(win, screenHeight - 1, 0);
     for (int i = 0; i < screenWidth; i++) {
-        addch('=');
+        waddch(win, '=');
     }
     
     // Dibujar bordes laterales
     for (int i = 1; i < screenHeight - 1; i++) {
-        mvaddch(i, 0, '|');
-        mvaddch(i, screenWidth - 1, '|');
+        mvwaddch(win, i, 0, '|');
+        mvwaddch(win, i, screenWidth - 1, '|');
     }
 }
 
-void MenuSystem::drawTitle() {
+void MenuSystem::drawTitle(WINDOW* win) {
     std::vector<std::string> title = {
         "  ███████ ██████   █████   ██████ ███████     ██ ███    ██ ██    ██  █████  ██████  ███████ ██████  ███████ ",
         "  ██      ██   ██ ██   ██ ██      ██          ██ ████   ██ ██    ██ ██   ██ ██   ██ ██      ██   ██ ██      ",
@@ -48,95 +52,79 @@ void MenuSystem::drawTitle() {
     };
     
     int startY = 3;
-    attron(COLOR_PAIR(5));
-    for (int i = 0; i < title.size(); i++) {
-        centerText(startY + i, title[i], 5);
+    for (size_t i = 0; i < title.size(); i++) {
+        centerText(win, startY + i, title[i], 5);
     }
-    attroff(COLOR_PAIR(5));
 }
 
-void MenuSystem::drawOptions(const std::vector<std::string>& options, int selected) {
-    int startY = screenHeight / 2 - 1;
+// Una sola fila de opciones sobre stdscr. Seleccionada o no ocupa el mismo
+// ancho, así que repintarla tapa por completo lo que había.
+void MenuSystem::drawOptionRow(int index, bool selected) {
+    int y = screenHeight / 2 - 1 + index;
     
-    for (int i = 0; i < options.size(); i++) {
-        if (i == selected) {
-            attron(A_REVERSE);
-            attron(COLOR_PAIR(4));
-            centerText(startY + i, "> " + options[i] + " <");
-            attroff(COLOR_PAIR(4));
-            attroff(A_REVERSE);
-        } else {
-            centerText(startY + i, "  " + options[i] + "  ");
-        }
+    if (selected) {
+        attron(A_REVERSE);
+        attron(COLOR_PAIR(4));
+        centerText(stdscr, y, "> " + mainMenuOptions[index] + " <");
+        attroff(COLOR_PAIR(4));
+        attroff(A_REVERSE);
+    } else {
+        centerText(stdscr, y, "  " + mainMenuOptions[index] + "  ");
     }
 }
 
-void MenuSystem::drawFooter() {
+void MenuSystem::drawFooter(WINDOW* win) {
     std::string controls = "Usar W/S o flechas para navegar, ENTER para seleccionar";
-    centerText(screenHeight - 3, controls, 4);
+    centerText(win, screenHeight - 3, controls, 4);
 }
 
-void MenuSystem::centerText(int y, const std::string& text, int colorPair) {
-    int x = (screenWidth - text.length()) / 2;
+void MenuSystem::centerText(WINDOW* win, int y, const std::string& text, int colorPair) {
+    int x = (screenWidth - static_cast<int>(text.length())) / 2;
     if (colorPair > 0) {
-        attron(COLOR_PAIR(colorPair));
+        wattron(win, COLOR_PAIR(colorPair));
     }
-    mvprintw(y, x, "%s", text.c_str());
+    mvwprintw(win, y, x, "%s", text.c_str());
     if (colorPair > 0) {
-        attroff(COLOR_PAIR(colorPair));
+        wattroff(win, COLOR_PAIR(colorPair));
     }
 }
 
-int MenuSystem::showMainMenu() {
-    int ch;
-    selectedOption = 0;
+// Devuelve true si la terminal cambió de tamaño; en ese caso las pantallas
+// pre-dibujadas ya no sirven
+bool MenuSystem::updateScreenSize() {
+    int height, width;
+    getmaxyx(stdscr, height, width);
+    if (height == screenHeight && width == screenWidth) {
+        return false;
+    }
     
-    while (true) {
-        clear();
-        getmaxyx(stdscr, screenHeight, screenWidth);
-        
-        drawBorder();
-        drawTitle();
-        drawOptions(mainMenuOptions, selectedOption);
-        drawFooter();
-        
-        refresh();
-        
-        ch = getch();
-        
-        switch (ch) {
-            case 'w':
-            case 'W':
-            case KEY_UP:
-                selectedOption = (selectedOption - 1 + mainMenuOptions.size()) % mainMenuOptions.size();
-                break;
-                
-            case 's':
-            case 'S':
-            case KEY_DOWN:
-                selectedOption = (selectedOption + 1) % mainMenuOptions.size();
-                break;
-                
-            case '\n':
-            case '\r':
-                return selectedOption + 1;
-                
-            case 27: // ESC
-                return 5; // Salir
-                
-            default:
-                break;
+    screenHeight = height;
+    screenWidth = width;
+    freePads();
+    return true;
+}
+
+void MenuSystem::freePads() {
+    WINDOW** pads[] = { &menuPad, &instructionsPad, &scoresPad };
+    for (WINDOW** pad : pads) {
+        if (*pad) {
+            delwin(*pad);
+            *pad = nullptr;
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 }
 
-void MenuSystem::showInstructions() {
-    clear();
-    getmaxyx(stdscr, screenHeight, screenWidth);
-    
-    drawBorder();
+WINDOW* MenuSystem::buildMenuPad() {
+    WINDOW* pad = newpad(screenHeight, screenWidth);
+    drawBorder(pad);
+    drawTitle(pad);
+    drawFooter(pad);
+    return pad;
+}
+
+WINDOW* MenuSystem::buildInstructionsPad() {
+    WINDOW* pad = newpad(screenHeight, screenWidth);
+    drawBorder(pad);
     
     std::vector<std::string> instructions = {
     "===============================================================",
@@ -153,18 +141,20 @@ void MenuSystem::showInstructions() {
     "  * D o -> : Mover nave hacia la derecha", 
     "  * W o ESPACIO : Disparar proyectil",
     "  * P : Pausar/reanudar juego",
+    "  * T : Mostrar/ocultar tiempos de rendimiento",
     "  * Q o ESC : Salir del juego",
     "  * R : Reiniciar partida (al terminar)",
     "",
     "ELEMENTOS DEL JUEGO:",
-    "  * Nave del jugador: [*] o <->",
-    "  * Invasores: ^ o @ o W",
+    "  * Nave del jugador: canon ^ sobre el casco [*]",
+    "  * Invasores: /W\\ o {@} o <^> (animados)",
     "  * Proyectiles del jugador: | o ^",
     "  * Proyectiles enemigos: | o v",
     "",
     "PUNTUACION:",
     "  * Cada invasor destruido: +10 puntos",
-    "  * Bonificacion por oleada completada",
+    "  * Racha (otro invasor en medio segundo): +5 por invasor, hasta +20",
+    "  * Oleada completada: +100 por numero de oleada",
     "",
     "MODALIDADES:",
     "  * Modo 1: 40 invasores en grupos de 8",
@@ -176,31 +166,28 @@ void MenuSystem::showInstructions() {
 };
     
     int startY = 2;
-    for (int i = 0; i < instructions.size(); i++) {
+    for (size_t i = 0; i < instructions.size(); i++) {
         if (i < 3 || instructions[i].find("OBJETIVO:") != std::string::npos ||
             instructions[i].find("CONTROLES:") != std::string::npos ||
             instructions[i].find("ELEMENTOS") != std::string::npos ||
             instructions[i].find("PUNTUACIÓN:") != std::string::npos ||
             instructions[i].find("MODALIDADES:") != std::string::npos) {
-            attron(COLOR_PAIR(4) | A_BOLD);
+            wattron(pad, COLOR_PAIR(4) | A_BOLD);
         }
         
-        centerText(startY + i, instructions[i]);
+        centerText(pad, startY + i, instructions[i]);
         
         if (i < 3 || instructions[i].find(":") != std::string::npos) {
-            attroff(COLOR_PAIR(4) | A_BOLD);
+            wattroff(pad, COLOR_PAIR(4) | A_BOLD);
         }
     }
     
-    refresh();
-    waitForKey();
+    return pad;
 }
 
-void MenuSystem::showHighScores() {
-    clear();
-    getmaxyx(stdscr, screenHeight, screenWidth);
-    
-    drawBorder();
+WINDOW* MenuSystem::buildScoresPad() {
+    WINDOW* pad = newpad(screenHeight, screenWidth);
+    drawBorder(pad);
     
     std::vector<std::string> scores = {
     "===============================================================",
@@ -209,48 +196,179 @@ void MenuSystem::showHighScores() {
     "",
     "+-------------------------------------------------------------+",
     "|  RANK  |    JUGADOR    |   PUNTOS   |    MODO    |   FECHA   |",
-    "+-------------------------------------------------------------+",
-    "|   1°   |   CHAMPION    |   99999    |   MODO 2   | 12/09/25  |",
-    "|   2°   |   ACE_PILOT   |   85420    |   MODO 2   | 11/09/25  |",
-    "|   3°   |   DEFENDER    |   76850    |   MODO 1   | 10/09/25  |",
-    "|   4°   |   ROOKIE_01   |   65230    |   MODO 1   | 09/09/25  |",
-    "|   5°   |   SPACE_WAR   |   54170    |   MODO 2   | 08/09/25  |",
-    "|   6°   |   GUARDIAN    |   48960    |   MODO 1   | 07/09/25  |",
-    "|   7°   |   NOVA_STAR   |   42340    |   MODO 1   | 06/09/25  |",
-    "|   8°   |   COSMIC_01   |   38720    |   MODO 2   | 05/09/25  |",
-    "|   9°   |   BLASTER     |   35140    |   MODO 1   | 04/09/25  |",
-    "|  10°   |   NEWBIE_X    |   28560    |   MODO 1   | 03/09/25  |",
-    "+-------------------------------------------------------------+",
-    "",
-    "* Los puntajes se mantienen durante la sesion actual",
-    "* Para aparecer en esta tabla, debes superar al menos 25,000 puntos",
-    "",
-    "Presiona cualquier tecla para regresar al menu principal..."
+    "+-------------------------------------------------------------+"
 };
     
+    // Los 10 mejores salen del índice de la cabecera del archivo, sin
+    // recorrer el historial
+    std::vector<ScoreRecord> best;
+    if (scoreStore && scoreStore->isOpen()) {
+        best = scoreStore->topScores(0, 10);
+    }
+    
+    for (size_t i = 0; i < 10; i++) {
+        char line[80];
+        if (i < best.size()) {
+            const ScoreRecord& record = best[i];
+            std::string name(record.name, strnlen(record.name, sizeof(record.name)));
+            
+            char date[16];
+            time_t when = static_cast<time_t>(record.timestamp);
+            struct tm local;
+            localtime_r(&when, &local);
+            strftime(date, sizeof(date), "%d/%m/%y", &local);
+            
+            snprintf(line, sizeof(line), "| %3zu°   | %-13.13s | %10d |   MODO %d   | %-9s |",
+                     i + 1, name.c_str(), record.score, record.mode, date);
+        } else {
+            snprintf(line, sizeof(line), "| %3zu°   | %-13s | %10s |    %-7s | %-9s |",
+                     i + 1, "---", "---", "---", "---");
+        }
+        scores.push_back(line);
+    }
+    
+    std::string footer = (scoreStore && scoreStore->isOpen())
+        ? "* " + std::to_string(scoreStore->size()) + " partidas guardadas en " + scoreStore->getPath()
+        : "* No hay archivo de puntajes (ver --scores)";
+    
+    scores.push_back("+-------------------------------------------------------------+");
+    scores.push_back("");
+    scores.push_back(footer);
+    scores.push_back("* Se guarda cada partida terminada (game over o victoria)");
+    scores.push_back("");
+    scores.push_back("Presiona cualquier tecla para regresar al menu principal...");
+    
     int startY = 2;
-    for (int i = 0; i < scores.size(); i++) {
+    for (size_t i = 0; i < scores.size(); i++) {
         if (i < 3) {
-            attron(COLOR_PAIR(4) | A_BOLD);
+            wattron(pad, COLOR_PAIR(4) | A_BOLD);
         } else if (i >= 5 && i <= 17) {
-            attron(COLOR_PAIR(3));
+            wattron(pad, COLOR_PAIR(3));
         }
         
-        centerText(startY + i, scores[i]);
+        centerText(pad, startY + i, scores[i]);
         
         if (i < 3) {
-            attroff(COLOR_PAIR(4) | A_BOLD);
+            wattroff(pad, COLOR_PAIR(4) | A_BOLD);
         } else if (i >= 5 && i <= 17) {
-            attroff(COLOR_PAIR(3));
+            wattroff(pad, COLOR_PAIR(3));
         }
     }
     
+    scoresPadRecords = (scoreStore && scoreStore->isOpen()) ? scoreStore->size() : 0;
+    return pad;
+}
+
+// Copia la pantalla entera a stdscr y la muestra. Sin clear(): ncurses
+// compara con lo que ya está en la terminal y manda solo las diferencias.
+void MenuSystem::showPad(WINDOW* pad) {
+    copywin(pad, stdscr, 0, 0, 0, 0, screenHeight - 1, screenWidth - 1, FALSE);
+}
+
+void MenuSystem::repaintMainMenu() {
+    updateScreenSize();
+    if (!menuPad) {
+        menuPad = buildMenuPad();
+    }
+    
+    showPad(menuPad);
+    for (size_t i = 0; i < mainMenuOptions.size(); i++) {
+        drawOptionRow(i, static_cast<int>(i) == selectedOption);
+    }
     refresh();
-    waitForKey();
 }
 
-void MenuSystem::waitForKey() {
+int MenuSystem::showMainMenu() {
+    int count = mainMenuOptions.size();
+    selectedOption = 0;
+    
+    // En el menú no hay nada que animar: getch() bloquea hasta que llega
+    // una tecla o un cambio de tamaño (KEY_RESIZE)
+    nodelay(stdscr, FALSE);
+    repaintMainMenu();
+    
+    int result = 0;
+    while (result == 0) {
+        int previous = selectedOption;
+        
+        switch (getch()) {
+            case 'w':
+            case 'W':
+            case KEY_UP:
+                selectedOption = (selectedOption - 1 + count) % count;
+                break;
+                
+            case 's':
+            case 'S':
+            case KEY_DOWN:
+                selectedOption = (selectedOption + 1) % count;
+                break;
+                
+            case '\n':
+            case '\r':
+                result = selectedOption + 1;
+                break;
+                
+            case 27: // ESC
+                result = 5; // Salir
+                break;
+                
+            case KEY_RESIZE:
+                repaintMainMenu();
+                break;
+                
+            default:
+                break;
+        }
+        
+        // Solo cambian las dos filas de la selección
+        if (selectedOption != previous) {
+            drawOptionRow(previous, false);
+            drawOptionRow(selectedOption, true);
+            refresh();
+        }
+    }
+    
+    nodelay(stdscr, TRUE);
+    return result;
+}
+
+void MenuSystem::showInstructions() {
+    int key;
+    do {
+        updateScreenSize();
+        if (!instructionsPad) {
+            instructionsPad = buildInstructionsPad();
+        }
+        showPad(instructionsPad);
+        refresh();
+        key = waitForKey();
+    } while (key == KEY_RESIZE);
+}
+
+void MenuSystem::showHighScores() {
+    int key;
+    do {
+        updateScreenSize();
+        
+        // La tabla solo cambia cuando se guardó otra partida
+        uint64_t records = (scoreStore && scoreStore->isOpen()) ? scoreStore->size() : 0;
+        if (scoresPad && records != scoresPadRecords) {
+            delwin(scoresPad);
+            scoresPad = nullptr;
+        }
+        if (!scoresPad) {
+            scoresPad = buildScoresPad();
+        }
+        showPad(scoresPad);
+        refresh();
+        key = waitForKey();
+    } while (key == KEY_RESIZE);
+}
+
+int MenuSystem::waitForKey() {
     nodelay(stdscr, FALSE);
-    getch();
+    int key = getch();
     nodelay(stdscr, TRUE);
+    return key;
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "PerfStats.h"
+#include <cstdio>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKETS; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    maxNs.store(0, std::memory_order_relaxed);
+}
+
+// Cubeta = 4 * (posición del bit más alto) + los 2 bits siguientes
+int LatencyHistogram::bucketFor(uint64_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return static_cast<int>(ns);
+    }
+    int log2 = 63 - __builtin_clzll(ns);
+    int sub = static_cast<int>((ns >> (log2 - 2)) & (SUB_BUCKETS - 1));
+    return log2 * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int log2 = bucket / SUB_BUCKETS;
+    int sub = bucket % SUB_BUCKETS;
+    return (uint64_t(SUB_BUCKETS + sub + 1) << (log2 - 2)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    counts[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    
+    uint64_t current = maxNs.load(std::memory_order_relaxed);
+    while (ns > current && !maxNs.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    
+    uint64_t target = static_cast<uint64_t>(p / 100.0 * n);
+    if (target >= n) target = n - 1;
+    
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+const char* PerfStats::phaseName(int phase) {
+    static const char* names[PHASE_COUNT] = {
+        "input", "player", "invaders", "bullets", "collision", "state", "score",
+        "tick", "render", "entity_lock_wait", "render_lock_wait"
+    };
+    return names[phase];
+}
+
+void PerfStats::reset() {
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        histograms[i].reset();
+        windows[0][i].reset();
+        windows[1][i].reset();
+    }
+}
+
+// La ventana que se va a llenar se vacía antes de activarla, así el hilo
+// de ticks no registra en una que se está borrando. Si el recuadro estuvo
+// oculto más de una ventana, lo acumulado ya no es reciente y se descarta.
+void PerfStats::advanceWindow(std::chrono::steady_clock::time_point now) {
+    auto elapsed = now - windowStart;
+    if (elapsed < std::chrono::milliseconds(WINDOW_MS)) {
+        return;
+    }
+    
+    int current = activeWindow.load(std::memory_order_relaxed);
+    bool stale = elapsed >= std::chrono::milliseconds(2 * WINDOW_MS);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        windows[current ^ 1][i].reset();
+        if (stale) {
+            windows[current][i].reset();
+        }
+    }
+    activeWindow.store(current ^ 1, std::memory_order_relaxed);
+    windowStart = now;
+}
+
+std::string PerfStats::report() const {
+    std::string out;
+    char line[128];
+    
+    snprintf(line, sizeof(line), "%-18s %10s %10s %10s %10s\n", "phase", "count", "p50", "p99", "max");
+    out += line;
+    
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const LatencyHistogram& h = histograms[i];
+        if (h.count() == 0) continue;
+        
+        snprintf(line, sizeof(line), "%-18s %10llu %10s %10s %10s\n", phaseName(i),
+                 static_cast<unsigned long long>(h.count()),
+                 formatDuration(h.percentile(50)).c_str(),
+                 formatDuration(h.percentile(99)).c_str(),
+                 formatDuration(h.max()).c_str());
+        out += line;
+    }
+    
+    return out;
+}
+
+std::string formatDuration(uint64_t ns) {
+    char text[32];
+    if (ns < 1000) {
+        snprintf(text, sizeof(text), "%lluns", static_cast<unsigned long long>(ns));
+    } else if (ns < 1000000) {
+        snprintf(text, sizeof(text), "%.1fus", ns / 1e3);
+    } else {
+        snprintf(text, sizeof(text), "%.1fms", ns / 1e6);
+    }
+    return text;
+}
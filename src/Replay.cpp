@@ -0,0 +1,185 @@
+#include "Replay.h"
+#include <cstring>
+
+static const char MAGIC[4] = {'S', 'I', 'R', 'P'};
+static const uint8_t VERSION = 5;      // 2: generador xoshiro, 3: formación configurable,
+                                       // 4: bonos de combo y de oleada, 5: sprites con máscara
+static const size_t HEADER_SIZE = 4 + 1 + 8 + 4 * 4 + 7 * 4;
+
+static void putU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static void putU64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static uint32_t getU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= uint32_t(in[i]) << (8 * i);
+    return value;
+}
+
+static uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= uint64_t(in[i]) << (8 * i);
+    return value;
+}
+
+// ===== Grabación =====
+
+InputRecorder::InputRecorder() : file(nullptr), lastTick(0) {
+}
+
+InputRecorder::~InputRecorder() {
+    if (file) {
+        close(lastTick);
+    }
+}
+
+bool InputRecorder::open(const std::string& path, const ReplayHeader& header) {
+    if (file) {
+        close(lastTick);
+    }
+    
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    
+    // Cabecera en little-endian, independiente del layout de la estructura
+    uint8_t bytes[HEADER_SIZE];
+    memcpy(bytes, MAGIC, 4);
+    bytes[4] = VERSION;
+    putU64(bytes + 5, header.seed);
+    putU32(bytes + 13, static_cast<uint32_t>(header.mode));
+    putU32(bytes + 17, static_cast<uint32_t>(header.width));
+    putU32(bytes + 21, static_cast<uint32_t>(header.height));
+    putU32(bytes + 25, static_cast<uint32_t>(header.bulletCapacity));
+    putU32(bytes + 29, static_cast<uint32_t>(header.formation.rows));
+    putU32(bytes + 33, static_cast<uint32_t>(header.formation.columns));
+    putU32(bytes + 37, static_cast<uint32_t>(header.formation.spacingX));
+    putU32(bytes + 41, static_cast<uint32_t>(header.formation.spacingY));
+    putU32(bytes + 45, static_cast<uint32_t>(header.formation.waves));
+    putU32(bytes + 49, static_cast<uint32_t>(header.formation.shootersPerVolley));
+    putU32(bytes + 53, static_cast<uint32_t>(header.formation.lives));
+    fwrite(bytes, 1, HEADER_SIZE, file);
+    
+    lastTick = 0;
+    return true;
+}
+
+void InputRecorder::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        fputc(static_cast<int>((value & 0x7F) | 0x80), file);
+        value >>= 7;
+    }
+    fputc(static_cast<int>(value), file);
+}
+
+void InputRecorder::record(long tick, InputCommand cmd) {
+    if (!file) {
+        return;
+    }
+    writeVarint(static_cast<uint64_t>(tick - lastTick));
+    fputc(cmd, file);
+    lastTick = tick;
+}
+
+void InputRecorder::close(long finalTick) {
+    if (!file) {
+        return;
+    }
+    record(finalTick, CMD_NONE);
+    fclose(file);
+    file = nullptr;
+}
+
+// ===== Reproducción =====
+
+InputReplay::InputReplay()
+    : pos(0), header{0, 1, 80, 24, 0, FormationConfig()}, nextTick(-1), nextCommand(CMD_NONE), endTick(-1) {
+}
+
+bool InputReplay::load(const std::string& path, std::string& error) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+    
+    data.clear();
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    
+    if (data.size() < HEADER_SIZE || memcmp(data.data(), MAGIC, 4) != 0) {
+        error = path + " no es una grabación";
+        return false;
+    }
+    if (data[4] != VERSION) {
+        error = path + ": versión de grabación no soportada";
+        return false;
+    }
+    
+    header.seed = getU64(&data[5]);
+    header.mode = static_cast<int>(getU32(&data[13]));
+    header.width = static_cast<int>(getU32(&data[17]));
+    header.height = static_cast<int>(getU32(&data[21]));
+    header.bulletCapacity = static_cast<int>(getU32(&data[25]));
+    header.formation.rows = static_cast<int>(getU32(&data[29]));
+    header.formation.columns = static_cast<int>(getU32(&data[33]));
+    header.formation.spacingX = static_cast<int>(getU32(&data[37]));
+    header.formation.spacingY = static_cast<int>(getU32(&data[41]));
+    header.formation.waves = static_cast<int>(getU32(&data[45]));
+    header.formation.shootersPerVolley = static_cast<int>(getU32(&data[49]));
+    header.formation.lives = static_cast<int>(getU32(&data[53]));
+    
+    pos = HEADER_SIZE;
+    nextTick = 0;
+    endTick = -1;
+    advance();
+    return true;
+}
+
+bool InputReplay::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decodifica el siguiente registro. Una grabación cortada (sin marcador de
+// fin) se reproduce hasta el último comando completo.
+void InputReplay::advance() {
+    uint64_t delta;
+    if (!readVarint(delta) || pos >= data.size()) {
+        nextTick = -1;
+        return;
+    }
+    
+    nextTick += static_cast<long>(delta);
+    nextCommand = static_cast<InputCommand>(data[pos++]);
+    
+    if (nextCommand == CMD_NONE) {
+        endTick = nextTick;
+        nextTick = -1;
+    }
+}
+
+bool InputReplay::pop(long tick, InputCommand& cmd) {
+    if (nextTick < 0 || nextTick != tick) {
+        return false;
+    }
+    cmd = nextCommand;
+    advance();
+    return true;
+}
@@ -0,0 +1,368 @@
+#include "ScoreStore.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <queue>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = {'S', 'I', 'S', 'C'};
+static const uint32_t VERSION = 1;
+static const off_t HEADER_SLOT = 4096;
+static const off_t DATA_OFFSET = 2 * HEADER_SLOT;
+
+// Cabecera tal como va en disco (una por slot)
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sequence;
+    uint64_t recordCount;
+    uint32_t topCount[ScoreStore::MAX_MODES];
+    ScoreIndexEntry top[ScoreStore::MAX_MODES][ScoreStore::TOP_K];
+    uint32_t crc;                       // De todos los bytes anteriores
+};
+
+static_assert(sizeof(ScoreRecord) == 32, "ScoreRecord debe ocupar 32 bytes");
+static_assert(sizeof(FileHeader) <= HEADER_SLOT, "La cabecera no cabe en su slot");
+
+static uint32_t crc32(const void* data, size_t length) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        ready = true;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t recordCrc(const ScoreRecord& record) {
+    return crc32(reinterpret_cast<const uint8_t*>(&record) + sizeof(record.crc),
+                 sizeof(record) - sizeof(record.crc));
+}
+
+static int modeSlot(int mode) {
+    return std::max(0, std::min(ScoreStore::MAX_MODES - 1, mode - 1));
+}
+
+ScoreStore::ScoreStore()
+    : fd(-1), map(nullptr), mapSize(0), sequence(0), recordCount(0) {
+    memset(top, 0, sizeof(top));
+    memset(topCount, 0, sizeof(topCount));
+}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+bool ScoreStore::open(const std::string& filePath) {
+    close();
+    path = filePath;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    flock(fd, LOCK_EX);
+
+    struct stat info;
+    fstat(fd, &info);
+
+    bool ok = true;
+    if (info.st_size < DATA_OFFSET) {
+        // Archivo nuevo: dos cabeceras vacías
+        sequence = 0;
+        recordCount = 0;
+        ok = ftruncate(fd, DATA_OFFSET) == 0 && writeHeader() && writeHeader();
+    } else if (loadHeader()) {
+        recoverTail();
+    } else {
+        // Ninguna cabecera válida: único caso en que se lee todo el historial
+        rebuildIndex();
+    }
+
+    flock(fd, LOCK_UN);
+
+    if (!ok || !remap()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ScoreStore::close() {
+    if (map) {
+        munmap(const_cast<uint8_t*>(map), mapSize);
+        map = nullptr;
+        mapSize = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool ScoreStore::loadHeader() {
+    FileHeader best;
+    bool found = false;
+
+    for (int slot = 0; slot < 2; slot++) {
+        FileHeader header;
+        if (pread(fd, &header, sizeof(header), slot * HEADER_SLOT) != sizeof(header)) continue;
+        if (memcmp(header.magic, MAGIC, 4) != 0 || header.version != VERSION) continue;
+        if (header.crc != crc32(&header, offsetof(FileHeader, crc))) continue;
+
+        if (!found || header.sequence > best.sequence) {
+            best = header;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    sequence = best.sequence;
+    recordCount = best.recordCount;
+    memcpy(top, best.top, sizeof(top));
+    memcpy(topCount, best.topCount, sizeof(topCount));
+    return true;
+}
+
+// Escribe la cabecera en el slot que no está vigente, así una escritura
+// cortada nunca deja sin cabecera válida
+bool ScoreStore::writeHeader() {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.sequence = ++sequence;
+    header.recordCount = recordCount;
+    memcpy(header.top, top, sizeof(top));
+    memcpy(header.topCount, topCount, sizeof(topCount));
+    header.crc = crc32(&header, offsetof(FileHeader, crc));
+
+    off_t offset = (header.sequence % 2) * HEADER_SLOT;
+    if (pwrite(fd, &header, sizeof(header), offset) != sizeof(header)) {
+        return false;
+    }
+    return fdatasync(fd) == 0;
+}
+
+// Registros completos y válidos después del último confirmado (una caída
+// entre escribir el registro y la cabecera) se adoptan. Normalmente no hay
+// ninguno, así que abrir cuesta lo mismo con mil o con millones de partidas.
+void ScoreStore::recoverTail() {
+    struct stat info;
+    fstat(fd, &info);
+    uint64_t available = (info.st_size - DATA_OFFSET) / sizeof(ScoreRecord);
+
+    uint64_t before = recordCount;
+    while (recordCount < available) {
+        ScoreRecord record;
+        off_t offset = DATA_OFFSET + recordCount * sizeof(ScoreRecord);
+        if (pread(fd, &record, sizeof(record), offset) != sizeof(record) ||
+            record.crc != recordCrc(record)) {
+            break;
+        }
+        insertTop(record, static_cast<uint32_t>(recordCount));
+        recordCount++;
+    }
+
+    if (recordCount != before) {
+        writeHeader();
+    }
+}
+
+void ScoreStore::rebuildIndex() {
+    sequence = 0;
+    recordCount = 0;
+    memset(top, 0, sizeof(top));
+    memset(topCount, 0, sizeof(topCount));
+    recoverTail();
+    writeHeader();
+}
+
+void ScoreStore::insertTop(const ScoreRecord& record, uint32_t index) {
+    int slot = modeSlot(record.mode);
+    ScoreIndexEntry* list = top[slot];
+    uint32_t& count = topCount[slot];
+
+    // Con empate queda primero el más antiguo
+    uint32_t position = count;
+    while (position > 0 && list[position - 1].score < record.score) {
+        position--;
+    }
+    if (position >= static_cast<uint32_t>(TOP_K)) {
+        return;
+    }
+
+    uint32_t last = std::min<uint32_t>(count, TOP_K - 1);
+    for (uint32_t i = last; i > position; i--) {
+        list[i] = list[i - 1];
+    }
+    list[position] = ScoreIndexEntry{record.score, index, record.timestamp};
+    count = std::min<uint32_t>(count + 1, TOP_K);
+}
+
+bool ScoreStore::remap() {
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (map && size == mapSize) {
+        return true;
+    }
+    if (map) {
+        munmap(const_cast<uint8_t*>(map), mapSize);
+        map = nullptr;
+    }
+
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        mapSize = 0;
+        return false;
+    }
+    map = static_cast<const uint8_t*>(address);
+    mapSize = size;
+    return true;
+}
+
+const ScoreRecord* ScoreStore::recordAt(uint64_t index) const {
+    size_t offset = DATA_OFFSET + index * sizeof(ScoreRecord);
+    if (!map || offset + sizeof(ScoreRecord) > mapSize) {
+        return nullptr;
+    }
+    return reinterpret_cast<const ScoreRecord*>(map + offset);
+}
+
+bool ScoreStore::append(int score, int mode, int wave, const std::string& name) {
+    if (fd < 0) {
+        return false;
+    }
+
+    flock(fd, LOCK_EX);
+
+    // Otro proceso pudo haber agregado desde la última vez
+    if (loadHeader()) {
+        recoverTail();
+    }
+
+    ScoreRecord record;
+    memset(&record, 0, sizeof(record));
+    record.score = score;
+    record.timestamp = static_cast<int64_t>(time(nullptr));
+    record.mode = static_cast<uint8_t>(mode);
+    record.wave = static_cast<uint8_t>(std::min(wave, 255));
+    // Sin terminador si ocupa los 12 bytes; quien lee lo acota al tamaño
+    memcpy(record.name, name.data(), std::min(name.size(), sizeof(record.name)));
+
+    // Fechas no decrecientes para poder buscar rangos por bisección
+    if (recordCount > 0) {
+        ScoreRecord previous;
+        off_t offset = DATA_OFFSET + (recordCount - 1) * sizeof(ScoreRecord);
+        if (pread(fd, &previous, sizeof(previous), offset) == sizeof(previous)) {
+            record.timestamp = std::max(record.timestamp, previous.timestamp);
+        }
+    }
+    record.crc = recordCrc(record);
+
+    // Primero el registro y después la cabecera que lo confirma
+    off_t offset = DATA_OFFSET + recordCount * sizeof(ScoreRecord);
+    bool ok = pwrite(fd, &record, sizeof(record), offset) == sizeof(record) &&
+              fdatasync(fd) == 0;
+    if (ok) {
+        insertTop(record, static_cast<uint32_t>(recordCount));
+        recordCount++;
+        ok = writeHeader();
+    }
+
+    flock(fd, LOCK_UN);
+
+    return remap() && ok;
+}
+
+std::vector<ScoreRecord> ScoreStore::topScores(int mode, int k) const {
+    std::vector<ScoreIndexEntry> entries;
+    for (int slot = 0; slot < MAX_MODES; slot++) {
+        if (mode != 0 && slot != modeSlot(mode)) continue;
+        entries.insert(entries.end(), top[slot], top[slot] + topCount[slot]);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const ScoreIndexEntry& a, const ScoreIndexEntry& b) {
+                         return a.score > b.score;
+                     });
+
+    std::vector<ScoreRecord> result;
+    for (const auto& entry : entries) {
+        if (static_cast<int>(result.size()) >= k) break;
+        const ScoreRecord* record = recordAt(entry.record);
+        if (record) {
+            result.push_back(*record);
+        }
+    }
+    return result;
+}
+
+std::vector<ScoreRecord> ScoreStore::topScoresBetween(int mode, int64_t from, int64_t to, int k) const {
+    // Primer registro con fecha >= t
+    auto lowerBound = [this](int64_t t) {
+        uint64_t low = 0, high = recordCount;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            const ScoreRecord* record = recordAt(mid);
+            if (record && record->timestamp < t) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    };
+
+    uint64_t begin = lowerBound(from);
+    uint64_t end = lowerBound(to);
+
+    // Montículo de mínimos con los k mejores vistos
+    auto worse = [](const ScoreRecord* a, const ScoreRecord* b) { return a->score > b->score; };
+    std::priority_queue<const ScoreRecord*, std::vector<const ScoreRecord*>, decltype(worse)> best(worse);
+
+    for (uint64_t i = begin; i < end && k > 0; i++) {
+        const ScoreRecord* record = recordAt(i);
+        if (!record || (mode != 0 && modeSlot(record->mode) != modeSlot(mode))) continue;
+
+        if (static_cast<int>(best.size()) < k) {
+            best.push(record);
+        } else if (record->score > best.top()->score) {
+            best.pop();
+            best.push(record);
+        }
+    }
+
+    std::vector<ScoreRecord> result;
+    while (!best.empty()) {
+        result.push_back(*best.top());
+        best.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
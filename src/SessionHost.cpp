@@ -0,0 +1,71 @@
+#include "SessionHost.h"
+#include "ThreadManager.h"
+#include "Sprite.h"
+
+SessionHost::SessionHost(int sessionCount, const SessionConfig& config, int workerThreads)
+    : pool(workerThreads) {
+    
+    sessions.resize(std::max(0, sessionCount));
+    
+    for (int i = 0; i < static_cast<int>(sessions.size()); i++) {
+        GameEngine* engine = new GameEngine(config.width, config.height);
+        engine->setBulletCapacity(config.bulletCapacity);
+        engine->setFormationConfig(config.formation);
+        engine->setSeed(config.seed + i);
+        engine->getThreadManager()->getPerfStats().setEnabled(false);
+        engine->startHeadless(config.mode);
+        
+        sessions[i] = Session{engine, 1, 0};
+    }
+}
+
+SessionHost::~SessionHost() {
+    for (auto& session : sessions) {
+        delete session.engine;
+    }
+}
+
+void SessionHost::autopilot(GameEngine& engine, int& sweep, long& gamesFinished) {
+    CommandQueue& commands = engine.getThreadManager()->getCommandQueue();
+    
+    if (engine.getGameState() == 2 || engine.getGameState() == 3) {
+        // Reiniciar también por la cola, para que quede en la grabación
+        gamesFinished++;
+        commands.push(CMD_RESTART);
+        return;
+    }
+    
+    // Mismos límites con los que inputPhase acota la nave
+    const Sprite& ship = Sprites::get(SPRITE_PLAYER);
+    int minX = 1 + ship.left();
+    int maxX = engine.getScreenWidth() - 2 - ship.right();
+    
+    Player* player = engine.getPlayer();
+    if (player->entity.x <= minX) {
+        sweep = 1;
+    } else if (player->entity.x >= maxX) {
+        sweep = -1;
+    }
+    commands.push(sweep > 0 ? CMD_RIGHT : CMD_LEFT);
+    commands.push(CMD_FIRE);
+}
+
+// Una sesión entera por índice: no hay barrera por tick porque las
+// sesiones no dependen unas de otras
+void SessionHost::run(long ticks) {
+    pool.parallelFor(size(), [this, ticks](int i) {
+        Session& session = sessions[i];
+        for (long t = 0; t < ticks; t++) {
+            autopilot(*session.engine, session.sweep, session.gamesFinished);
+            session.engine->tick();
+        }
+    });
+}
+
+long SessionHost::gamesFinished() const {
+    long total = 0;
+    for (const auto& session : sessions) {
+        total += session.gamesFinished;
+    }
+    return total;
+}
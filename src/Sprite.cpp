@@ -0,0 +1,79 @@
+#include "Sprite.h"
+#include <algorithm>
+#include <cstring>
+
+Sprite::Sprite(const char* const* art, int frameCount, int rows, int ax, int ay)
+    : width(0), height(std::min(rows, MAX_HEIGHT)), frames(std::min(frameCount, MAX_FRAMES)),
+      anchorX(ax), anchorY(ay) {
+
+    memset(glyphs, ' ', sizeof(glyphs));
+    memset(rowMasks, 0, sizeof(rowMasks));
+
+    for (int frame = 0; frame < frames; frame++) {
+        for (int row = 0; row < height; row++) {
+            const char* line = art[frame * rows + row];
+            int length = std::min(static_cast<int>(strlen(line)), MAX_WIDTH);
+            width = std::max(width, length);
+
+            for (int column = 0; column < length; column++) {
+                glyphs[frame][row][column] = line[column];
+                if (line[column] != ' ') {
+                    rowMasks[frame][row] |= static_cast<uint16_t>(1u << column);
+                }
+            }
+        }
+    }
+}
+
+// Los invasores ocupan una fila para que la formación quepa en una terminal
+// de 24 filas; el pulpo recoge los tentáculos en el segundo cuadro y ahí
+// solo lo alcanza un disparo al centro.
+static const char* const SQUID_ART[] = {
+    "/W\\",
+    "\\W/"
+};
+
+static const char* const CRAB_ART[] = {
+    "{@}",
+    "}@{"
+};
+
+static const char* const OCTOPUS_ART[] = {
+    "<^>",
+    " ^ "
+};
+
+// Nave: el cañón arriba (el ancla, de donde salen los disparos) y el casco
+// abajo. Un proyectil que pasa junto al cañón recién pega en el casco.
+static const char* const PLAYER_ART[] = {
+    " ^ ",
+    "[*]",
+    " ^ ",
+    "[+]"
+};
+
+static const Sprite SPRITES[SPRITE_COUNT] = {
+    Sprite(SQUID_ART, 2, 1, 1, 0),
+    Sprite(CRAB_ART, 2, 1, 1, 0),
+    Sprite(OCTOPUS_ART, 2, 1, 1, 0),
+    Sprite(PLAYER_ART, 2, 2, 1, 0)
+};
+
+const Sprite& Sprites::get(SpriteId id) {
+    return SPRITES[id];
+}
+
+SpriteId Sprites::invaderForRow(int row) {
+    static const SpriteId kinds[] = { SPRITE_SQUID, SPRITE_CRAB, SPRITE_OCTOPUS };
+    return kinds[row % 3];
+}
+
+int Sprites::invaderWidth() {
+    return std::max({SPRITES[SPRITE_SQUID].getWidth(), SPRITES[SPRITE_CRAB].getWidth(),
+                     SPRITES[SPRITE_OCTOPUS].getWidth()});
+}
+
+int Sprites::invaderHeight() {
+    return std::max({SPRITES[SPRITE_SQUID].getHeight(), SPRITES[SPRITE_CRAB].getHeight(),
+                     SPRITES[SPRITE_OCTOPUS].getHeight()});
+}
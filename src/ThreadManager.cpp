@@ -1,32 +1,23 @@
 #include "ThreadManager.h"
 #include "GameEngine.h"
+#include "WorkerPool.h"
+#include "Sprite.h"
 #include <chrono>
 #include <thread>
-#include <cstdlib>
-#include <ctime>
 #include <algorithm>
+#include <unistd.h>
 
 ThreadManager::ThreadManager(GameEngine* engine) 
-    : gameEngine(engine), threadsRunning(false) {
+    : workerPool(nullptr), inputHandler(nullptr),
+      entityMutex("entityMutex"), scoreMutex("scoreMutex"),
+      gameStateMutex("gameStateMutex"), renderMutex("renderMutex"),
+      tickParked(false), wakePending(false), renderPending(false), stateChanged(false),
+      tickPacer(60.0), renderPacer(30.0), gameEngine(engine), threadsRunning(false) {
     
-    // Inicializar mutexes
-    pthread_mutex_init(&entityMutex, nullptr);
-    pthread_mutex_init(&scoreMutex, nullptr);
-    pthread_mutex_init(&gameStateMutex, nullptr);
-    pthread_mutex_init(&renderMutex, nullptr);
-    
-    // Inicializar semáforos
-    sem_init(&playerActionSem, 0, 1);
-    sem_init(&invaderActionSem, 0, 1);
-    
-    // Inicializar barrera (10 hilos participantes)
-    pthread_barrier_init(&updateBarrier, nullptr, 10);
-    
-    // Inicializar variable de condición
+    // Inicializar variables de condición
     pthread_cond_init(&renderCondition, nullptr);
-    
-    // Inicializar generador de números aleatorios
-    srand(time(nullptr));
+    pthread_cond_init(&wakeCondition, nullptr);
+    pthread_cond_init(&stateCondition, nullptr);
 }
 
 ThreadManager::~ThreadManager() {
@@ -34,493 +25,550 @@ ThreadManager::~ThreadManager() {
         stopThreads();
     }
     
-    // Destruir mutexes
-    pthread_mutex_destroy(&entityMutex);
-    pthread_mutex_destroy(&scoreMutex);
-    pthread_mutex_destroy(&gameStateMutex);
-    pthread_mutex_destroy(&renderMutex);
-    
-    // Destruir semáforos
-    sem_destroy(&playerActionSem);
-    sem_destroy(&invaderActionSem);
-    
-    // Destruir barrera
-    pthread_barrier_destroy(&updateBarrier);
-    
-    // Destruir variable de condición
+    // Destruir variables de condición
     pthread_cond_destroy(&renderCondition);
+    pthread_cond_destroy(&wakeCondition);
+    pthread_cond_destroy(&stateCondition);
 }
 
 void ThreadManager::startThreads() {
     threadsRunning = true;
     
+    // Como mucho dos fases corren a la vez, así que basta un pool pequeño
+    workerPool = new WorkerPool(WorkerPool::defaultSize(1));
+    
     // Preparar datos para cada hilo
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < 2; i++) {
         threadDataArray[i].engine = gameEngine;
         threadDataArray[i].threadId = i;
         threadDataArray[i].running = &threadsRunning;
     }
     
-    // Crear los 10 hilos
-    pthread_create(&playerMovementThread, nullptr, playerMovementFunc, &threadDataArray[0]);
-    pthread_create(&playerShootingThread, nullptr, playerShootingFunc, &threadDataArray[1]);
-    pthread_create(&invaderMovementThread, nullptr, invaderMovementFunc, &threadDataArray[2]);
-    pthread_create(&invaderShootingThread, nullptr, invaderShootingFunc, &threadDataArray[3]);
-    pthread_create(&bulletUpdateThread, nullptr, bulletUpdateFunc, &threadDataArray[4]);
-    pthread_create(&collisionDetectionThread, nullptr, collisionDetectionFunc, &threadDataArray[5]);
-    pthread_create(&renderThread, nullptr, renderFunc, &threadDataArray[6]);
-    pthread_create(&inputHandlerThread, nullptr, inputHandlerFunc, &threadDataArray[7]);
-    pthread_create(&scoreUpdateThread, nullptr, scoreUpdateFunc, &threadDataArray[8]);
-    pthread_create(&gameStateThread, nullptr, gameStateFunc, &threadDataArray[9]);
+    // Descartar comandos que quedaron de una partida anterior
+    InputCommand stale;
+    while (commandQueue.pop(stale)) {}
+    
+    tickParked = false;
+    wakePending = false;
+    renderPending = false;
+    stateChanged = false;
+    
+    inputHandler = new InputHandler(commandQueue, STDIN_FILENO);
+    inputHandler->setNotify(wakeFromInput, this);
+    inputHandler->start();
+    
+    pthread_create(&tickThread, nullptr, tickFunc, &threadDataArray[0]);
+    pthread_create(&renderThread, nullptr, renderFunc, &threadDataArray[1]);
 }
 
 void ThreadManager::stopThreads() {
+    // Bajo el mutex para que un hilo dormido no se pierda el aviso
+    gameStateMutex.lock();
     threadsRunning = false;
+    pthread_cond_broadcast(&wakeCondition);
+    pthread_cond_broadcast(&renderCondition);
+    gameStateMutex.unlock();
     
-    // Esperar a que todos los hilos terminen
-    pthread_join(playerMovementThread, nullptr);
-    pthread_join(playerShootingThread, nullptr);
-    pthread_join(invaderMovementThread, nullptr);
-    pthread_join(invaderShootingThread, nullptr);
-    pthread_join(bulletUpdateThread, nullptr);
-    pthread_join(collisionDetectionThread, nullptr);
+    // Esperar a que los hilos terminen
+    pthread_join(tickThread, nullptr);
     pthread_join(renderThread, nullptr);
-    pthread_join(inputHandlerThread, nullptr);
-    pthread_join(scoreUpdateThread, nullptr);
-    pthread_join(gameStateThread, nullptr);
+    
+    inputHandler->stop();
+    delete inputHandler;
+    inputHandler = nullptr;
+    
+    delete workerPool;
+    workerPool = nullptr;
 }
 
-// HILO 1: Movimiento del jugador
-void* ThreadManager::playerMovementFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    while (*(data->running)) {
-        sem_wait(data->engine->getThreadManager()->getPlayerActionSem());
-        
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-        
-        if (data->engine->getGameState() == 0) {
-            Player* player = data->engine->getPlayer();
-            if (player->entity.x < 1) player->entity.x = 1;
-            if (player->entity.x >= data->engine->getScreenWidth() - 2) {
-                player->entity.x = data->engine->getScreenWidth() - 3;
+// Avanza un tick completo de simulación. Las fases corren en orden de
+// dependencias; solo las que tocan datos disjuntos (jugador e invasores)
+// se reparten en el pool. Sin pool (modo headless) todo corre en serie.
+// Cada fase queda registrada en su histograma de tiempos.
+void ThreadManager::runTick() {
+    ScopedPhaseTimer tickTimer(perfStats, PerfStats::TICK);
+    
+    runPhase(PerfStats::INPUT, inputPhase);
+    
+    if (workerPool) {
+        workerPool->parallelFor(2, [this](int phase) {
+            if (phase == 0) {
+                runPhase(PerfStats::PLAYER, playerPhase);
+            } else {
+                runPhase(PerfStats::INVADERS, invaderPhase);
             }
-        }
-        
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        sem_post(data->engine->getThreadManager()->getPlayerActionSem());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        });
+    } else {
+        runPhase(PerfStats::PLAYER, playerPhase);
+        runPhase(PerfStats::INVADERS, invaderPhase);
     }
     
-    return nullptr;
+    runPhase(PerfStats::BULLETS, bulletUpdateStep);
+    runPhase(PerfStats::COLLISION, collisionDetectionStep);
+    runPhase(PerfStats::SCORE, scoreUpdateStep);
+    runPhase(PerfStats::STATE, gameStateStep);
+    
+    gameEngine->countTick();
 }
 
-// HILO 2: Disparos del jugador
-void* ThreadManager::playerShootingFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-        
-        if (data->engine->getGameState() == 0 && data->engine->shouldPlayerShoot()) {
-            Player* player = data->engine->getPlayer();
-            std::vector<Entity>* bullets = data->engine->getPlayerBullets();
-            
-            if (bullets->size() < 3) {
-                Entity bullet(player->entity.x, player->entity.y - 1, '^', 3);
-                bullets->push_back(bullet);
-                data->engine->setPlayerShoot(false);
-            }
-        }
-        
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+void ThreadManager::runPhase(PerfStats::Phase phase, void (*fn)(GameEngine*)) {
+    ScopedPhaseTimer timer(perfStats, phase);
+    fn(gameEngine);
+}
+
+// ===== Dormir sin ticks =====
+
+void ThreadManager::wake() {
+    gameStateMutex.lock();
+    wakePending = true;
+    pthread_cond_signal(&wakeCondition);
+    gameStateMutex.unlock();
+}
+
+void ThreadManager::wakeFromInput(void* arg) {
+    static_cast<ThreadManager*>(arg)->wake();
+}
+
+void ThreadManager::notifyStateChange() {
+    gameStateMutex.lock();
+    stateChanged = true;
+    pthread_cond_broadcast(&stateCondition);
+    gameStateMutex.unlock();
+}
+
+void ThreadManager::waitStateChange() {
+    gameStateMutex.lock();
+    while (!stateChanged) {
+        gameStateMutex.wait(&stateCondition);
+    }
+    stateChanged = false;
+    gameStateMutex.unlock();
+}
+
+// Con el juego en pausa o terminado un tick no cambia nada salvo consumir
+// entrada, así que el planificador duerme hasta que llega una tecla. Los
+// ticks no avanzan mientras tanto; la grabación anota el tick en que se
+// consumió cada comando, así que la reproducción sigue siendo exacta.
+void ThreadManager::parkTicks() {
+    gameStateMutex.lock();
+    tickParked = true;
+    renderPending = true;
+    pthread_cond_broadcast(&renderCondition);
+    
+    while (threadsRunning && !wakePending) {
+        gameStateMutex.wait(&wakeCondition);
     }
+    wakePending = false;
+    tickParked = false;
+    pthread_cond_broadcast(&renderCondition);
+    gameStateMutex.unlock();
     
-    return nullptr;
+    // Sin recuperar los ticks del tiempo dormido
+    tickPacer.start();
 }
 
-// HILO 3: Movimiento de invasores
-void* ThreadManager::invaderMovementFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    static int moveCounter = 0;
-    static int direction = 1;
+// El renderizado dibuja una vez el último frame y duerme hasta que el
+// planificador vuelve a correr o publica otro frame
+void ThreadManager::parkRender() {
+    gameStateMutex.lock();
+    while (threadsRunning && tickParked && !renderPending) {
+        gameStateMutex.wait(&renderCondition);
+    }
+    gameStateMutex.unlock();
     
-    while (*(data->running)) {
-        sem_wait(data->engine->getThreadManager()->getInvaderActionSem());
-        
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-        
-        if (data->engine->getGameState() == 0) {
-            moveCounter++;
-            
-            if (moveCounter >= 30) {
-                moveCounter = 0;
-                std::vector<Entity>* invaders = data->engine->getInvaders();
-                
-                bool shouldMoveDown = false;
-                
-                for (auto& invader : *invaders) {
-                    if (invader.active) {
-                        invader.x += direction;
-                        
-                        if (invader.x <= 1 || invader.x >= data->engine->getScreenWidth() - 2) {
-                            shouldMoveDown = true;
-                        }
-                    }
-                }
-                
-                if (shouldMoveDown) {
-                    direction *= -1;
-                    for (auto& invader : *invaders) {
-                        if (invader.active) {
-                            invader.y++;
-                        }
-                    }
-                }
-            }
+    renderPacer.start();
+}
+
+// ===== Fases =====
+
+// Vacía la cola de comandos y los combina antes de aplicarlos, así que una
+// ráfaga de teclas cuesta lo mismo que una sola: el movimiento se suma y
+// se recorta al campo una vez, y disparar, pausar o mostrar los tiempos
+// cuentan como una acción por tick. Corre dentro del tick, que ya tiene
+// entityMutex tomado; ya no toca ncurses.
+void ThreadManager::inputPhase(GameEngine* engine) {
+    ThreadManager* manager = engine->getThreadManager();
+    
+    int dx = 0;
+    bool fire = false, quit = false, restart = false;
+    int pauseToggles = 0, perfToggles = 0;
+    
+    InputRecorder* recorder = engine->getRecorder();
+    
+    InputCommand cmd;
+    while (manager->commandQueue.pop(cmd)) {
+        // Se graba lo que consume la simulación, con el tick en que lo hace
+        if (recorder->isOpen()) {
+            recorder->record(engine->getTickCount(), cmd);
         }
         
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        sem_post(data->engine->getThreadManager()->getInvaderActionSem());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        switch (cmd) {
+            case CMD_LEFT:        dx--; break;
+            case CMD_RIGHT:       dx++; break;
+            case CMD_FIRE:        fire = true; break;
+            case CMD_PAUSE:       pauseToggles++; break;
+            case CMD_QUIT:        quit = true; break;
+            case CMD_RESTART:     restart = true; break;
+            case CMD_TOGGLE_PERF: perfToggles++; break;
+            default: break;
+        }
     }
     
-    return nullptr;
-}
-
-// HILO 4: Disparos de invasores
-void* ThreadManager::invaderShootingFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    static int shootTimer = 0;
+    if (quit) {
+        engine->setRunning(false);
+        manager->notifyStateChange();
+        return;
+    }
     
-    while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-        
-        if (data->engine->getGameState() == 0) {
-            shootTimer++;
-            
-            if (shootTimer >= 60) {
-                shootTimer = 0;
-                
-                std::vector<Entity>* invaders = data->engine->getInvaders();
-                std::vector<Entity>* bullets = data->engine->getInvaderBullets();
-                
-                if (!invaders->empty()) {
-                    std::vector<int> activeIndices;
-                    for (size_t i = 0; i < invaders->size(); i++) {
-                        if ((*invaders)[i].active) {
-                            activeIndices.push_back(i);
-                        }
-                    }
-                    
-                    if (!activeIndices.empty()) {
-                        int randomIdx = activeIndices[rand() % activeIndices.size()];
-                        Entity bullet((*invaders)[randomIdx].x, 
-                                    (*invaders)[randomIdx].y + 1, 'v', 2);
-                        bullets->push_back(bullet);
-                    }
-                }
-            }
+    int currentState = engine->getGameState();
+    
+    if ((currentState == 0 || currentState == 1) && (pauseToggles & 1)) {
+        manager->getGameStateMutex()->lock();
+        engine->setGameState(currentState == 0 ? 1 : 0);
+        manager->getGameStateMutex()->unlock();
+        
+    } else if ((currentState == 2 || currentState == 3) && restart) {
+        manager->getGameStateMutex()->lock();
+        engine->resetGame();
+        manager->getGameStateMutex()->unlock();
+        
+    } else if (currentState == 0) { // Jugando
+        if (dx != 0) {
+            Player* player = engine->getPlayer();
+            const Sprite& ship = Sprites::get(SPRITE_PLAYER);
+            player->entity.x = std::max(1 + ship.left(),
+                                        std::min(engine->getScreenWidth() - 2 - ship.right(),
+                                                 player->entity.x + dx));
+        }
+        if (fire) {
+            engine->setPlayerShoot(true);
         }
-        
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
     
-    return nullptr;
+    if (currentState == 0 && (perfToggles & 1)) {
+        engine->togglePerfOverlay();
+    }
 }
 
-// HILO 5: Actualización de proyectiles
-void* ThreadManager::bulletUpdateFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
+void ThreadManager::playerPhase(GameEngine* engine) {
+    playerMovementStep(engine);
+    playerShootingStep(engine);
+}
+
+void ThreadManager::invaderPhase(GameEngine* engine) {
+    invaderMovementStep(engine);
+    invaderShootingStep(engine);
+}
+
+// ===== Pasos de simulación (un tick, sin sincronización) =====
+
+void ThreadManager::playerMovementStep(GameEngine* engine) {
+    if (engine->getGameState() == 0) {
+        Player* player = engine->getPlayer();
+        const Sprite& ship = Sprites::get(SPRITE_PLAYER);
+        int minX = 1 + ship.left();
+        int maxX = engine->getScreenWidth() - 2 - ship.right();
+        if (player->entity.x < minX) player->entity.x = minX;
+        if (player->entity.x > maxX) player->entity.x = maxX;
+    }
+}
+
+void ThreadManager::playerShootingStep(GameEngine* engine) {
+    if (engine->getGameState() == 0 && engine->shouldPlayerShoot()) {
+        Player* player = engine->getPlayer();
+        BulletPool* bullets = engine->getPlayerBullets();
+        
+        // El disparo sale justo arriba del cañón (el ancla de la nave)
+        int muzzleY = player->entity.y - Sprites::get(SPRITE_PLAYER).above() - 1;
+        if (bullets->size() < 3 &&
+            bullets->spawn(player->entity.x, muzzleY, '^', 3)) {
+            engine->setPlayerShoot(false);
+            engine->emit(EVT_SHOT_FIRED);
+        }
+    }
+}
+
+void ThreadManager::invaderMovementStep(GameEngine* engine) {
+    int& moveCounter = engine->getInvaderMoveCounter();
+    int& direction = engine->getInvaderDirection();
     
-    while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
+    if (engine->getGameState() == 0) {
+        moveCounter++;
         
-        if (data->engine->getGameState() == 0) {
-            std::vector<Entity>* playerBullets = data->engine->getPlayerBullets();
-            for (auto it = playerBullets->begin(); it != playerBullets->end();) {
-                it->y--;
-                if (it->y < 1) {
-                    it = playerBullets->erase(it);
-                } else {
-                    ++it;
-                }
-            }
+        if (moveCounter >= 30) {
+            moveCounter = 0;
+            InvaderFormation* invaders = engine->getInvaders();
             
-            std::vector<Entity>* invaderBullets = data->engine->getInvaderBullets();
-            for (auto it = invaderBullets->begin(); it != invaderBullets->end();) {
-                it->y++;
-                if (it->y >= data->engine->getScreenHeight() - 1) {
-                    it = invaderBullets->erase(it);
-                } else {
-                    ++it;
-                }
+            invaders->stepX(direction);
+            
+            bool shouldMoveDown = invaders->anyActiveOutside(1, engine->getScreenWidth() - 2);
+            
+            if (shouldMoveDown) {
+                direction *= -1;
+                invaders->dropY();
             }
         }
-        
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
-    
-    return nullptr;
 }
 
-// HILO 6: Detección de colisiones
-void* ThreadManager::collisionDetectionFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
+void ThreadManager::invaderShootingStep(GameEngine* engine) {
+    int& shootTimer = engine->getInvaderShootTimer();
     
-    while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-        pthread_mutex_lock(data->engine->getThreadManager()->getScoreMutex());
+    if (engine->getGameState() == 0) {
+        shootTimer++;
         
-        if (data->engine->getGameState() == 0) {
-            std::vector<Entity>* playerBullets = data->engine->getPlayerBullets();
-            std::vector<Entity>* invaderBullets = data->engine->getInvaderBullets();
-            std::vector<Entity>* invaders = data->engine->getInvaders();
-            Player* player = data->engine->getPlayer();
+        if (shootTimer >= 60) {
+            shootTimer = 0;
             
-            for (auto& bullet : *playerBullets) {
-                for (auto& invader : *invaders) {
-                    if (bullet.active && invader.active &&
-                        bullet.x == invader.x && bullet.y == invader.y) {
-                        bullet.active = false;
-                        invader.active = false;
-                        player->score += 10;
-                    }
-                }
-            }
+            InvaderFormation* invaders = engine->getInvaders();
+            BulletPool* bullets = engine->getInvaderBullets();
             
-            for (auto& bullet : *invaderBullets) {
-                if (bullet.active && player->entity.active &&
-                    bullet.x == player->entity.x && bullet.y == player->entity.y) {
-                    bullet.active = false;
-                    player->lives--;
+            // Candidatos mantenidos por la formación: sin recorrerla ni
+            // reservar memoria por disparo
+            int candidates = invaders->liveCount();
+            int shots = std::min(candidates, engine->getFormation().shootersPerVolley);
+            for (int shot = 0; shot < shots; shot++) {
+                int shooter = invaders->liveAt(engine->getRandom().nextBelow(candidates));
+                if (!bullets->spawn(invaders->x(shooter), invaders->bottomY(shooter) + 1, 'v', 2)) {
+                    break;
                 }
             }
-            
-            playerBullets->erase(
-                std::remove_if(playerBullets->begin(), playerBullets->end(),
-                              [](const Entity& e) { return !e.active; }),
-                playerBullets->end());
-                
-            invaderBullets->erase(
-                std::remove_if(invaderBullets->begin(), invaderBullets->end(),
-                              [](const Entity& e) { return !e.active; }),
-                invaderBullets->end());
         }
-        
-        pthread_mutex_unlock(data->engine->getThreadManager()->getScoreMutex());
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
-    
-    return nullptr;
 }
 
-// HILO 7: Renderizado
-void* ThreadManager::renderFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getRenderMutex());
+// Los proyectiles que salen del campo se quitan con swap-remove: el índice
+// no avanza porque el hueco lo ocupa ahora el último proyectil.
+void ThreadManager::bulletUpdateStep(GameEngine* engine) {
+    if (engine->getGameState() == 0) {
+        BulletPool* playerBullets = engine->getPlayerBullets();
+        for (int i = 0; i < playerBullets->size();) {
+            Entity& bullet = (*playerBullets)[i];
+            bullet.y--;
+            if (bullet.y < 1) {
+                playerBullets->despawn(i);
+            } else {
+                i++;
+            }
+        }
         
-        data->engine->render();
+        BulletPool* invaderBullets = engine->getInvaderBullets();
+        for (int i = 0; i < invaderBullets->size();) {
+            Entity& bullet = (*invaderBullets)[i];
+            bullet.y++;
+            if (bullet.y >= engine->getScreenHeight() - 1) {
+                invaderBullets->despawn(i);
+            } else {
+                i++;
+            }
+        }
+    }
+}
+
+// Solo resuelve impactos y emite eventos: puntaje y vidas los aplica la
+// fase de puntaje, así que este recorrido no escribe nada del jugador.
+void ThreadManager::collisionDetectionStep(GameEngine* engine) {
+    if (engine->getGameState() == 0) {
+        BulletPool* playerBullets = engine->getPlayerBullets();
+        BulletPool* invaderBullets = engine->getInvaderBullets();
+        const Player* player = engine->getPlayer();
+        bool killed = false;
+        
+        // Cada proyectil consulta la celda que ocupa: O(1) por proyectil,
+        // sin importar cuántos invasores haya ni de cuántas celdas sea su
+        // sprite (una rejilla y un AND con la máscara de la fila)
+        for (int i = 0; i < playerBullets->size();) {
+            const Entity& bullet = (*playerBullets)[i];
+            
+            int hit = engine->invaderAt(bullet.x, bullet.y);
+            if (hit >= 0) {
+                engine->destroyInvader(hit);
+                engine->emit(EVT_INVADER_KILLED, hit);
+                killed = true;
+                playerBullets->despawn(i);
+            } else {
+                i++;
+            }
+        }
         
-        pthread_mutex_unlock(data->engine->getThreadManager()->getRenderMutex());
+        if (killed && !engine->getInvaders()->hasLive()) {
+            engine->emit(EVT_WAVE_CLEARED, engine->getWave());
+        }
         
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
+        const Sprite& ship = Sprites::get(SPRITE_PLAYER);
+        int shipFrame = Sprites::playerFrame(engine->getTickCount());
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(33));
+        for (int i = 0; i < invaderBullets->size();) {
+            const Entity& bullet = (*invaderBullets)[i];
+            
+            if (player->entity.active &&
+                ship.hits(shipFrame, bullet.x - player->entity.x, bullet.y - player->entity.y)) {
+                engine->emit(EVT_PLAYER_HIT);
+                invaderBullets->despawn(i);
+            } else {
+                i++;
+            }
+        }
     }
-    
-    return nullptr;
 }
 
-// HILO 8: Manejo de entrada - ARREGLADO
-void* ThreadManager::inputHandlerFunc(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    while (*(data->running)) {
-        int ch = getch();
-        
-        if (ch != ERR) {
-            int currentState = data->engine->getGameState();
-            
-            // Manejar input según estado
-            if (currentState == 0) { // Jugando
-                pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-                
-                switch (ch) {
-                    case 'a':
-                    case 'A':
-                    case KEY_LEFT:
-                        if (data->engine->getPlayer()->entity.x > 1) {
-                            data->engine->getPlayer()->entity.x--;
-                        }
-                        break;
-                        
-                    case 'd':
-                    case 'D':
-                    case KEY_RIGHT:
-                        if (data->engine->getPlayer()->entity.x < data->engine->getScreenWidth() - 2) {
-                            data->engine->getPlayer()->entity.x++;
-                        }
-                        break;
-                        
-                    case 'w':
-                    case 'W':
-                    case ' ':
-                        data->engine->setPlayerShoot(true);
-                        break;
-                        
-                    case 'p':
-                    case 'P':
-                        pthread_mutex_lock(data->engine->getThreadManager()->getGameStateMutex());
-                        data->engine->setGameState(1);
-                        pthread_mutex_unlock(data->engine->getThreadManager()->getGameStateMutex());
-                        break;
-                        
-                    case 'q':
-                    case 'Q':
-                    case 27: // ESC
-                        data->engine->setRunning(false);
-                        break;
-                }
+// Único consumidor de los eventos del tick: aplica puntaje, vidas, rachas
+// y estadísticas en el orden en que se emitieron. Vacía la cola aunque no
+// se esté jugando para que no queden eventos de una partida terminada.
+void ThreadManager::scoreUpdateStep(GameEngine* engine) {
+    Player* player = engine->getPlayer();
+    GameStats& stats = engine->getStats();
+    long tick = engine->getTickCount();
+    
+    GameEvent event;
+    while (engine->getEvents().pop(event)) {
+        switch (event.type) {
+            case EVT_SHOT_FIRED:
+                stats.shotsFired++;
+                break;
                 
-                pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
+            case EVT_INVADER_KILLED:
+                stats.combo = (tick - stats.lastKillTick <= GameStats::COMBO_WINDOW) ? stats.combo + 1 : 1;
+                stats.lastKillTick = tick;
+                stats.bestCombo = std::max(stats.bestCombo, stats.combo);
+                stats.invadersKilled++;
+                player->score += GameStats::KILL_POINTS +
+                    std::min(GameStats::COMBO_BONUS * (stats.combo - 1), GameStats::COMBO_MAX_BONUS);
+                break;
                 
-            } else if (currentState == 1) { // Pausa
-                switch (ch) {
-                    case 'p':
-                    case 'P':
-                        pthread_mutex_lock(data->engine->getThreadManager()->getGameStateMutex());
-                        data->engine->setGameState(0);
-                        pthread_mutex_unlock(data->engine->getThreadManager()->getGameStateMutex());
-                        break;
-                        
-                    case 'q':
-                    case 'Q':
-                    case 27: // ESC
-                        data->engine->setRunning(false);
-                        break;
-                }
+            case EVT_PLAYER_HIT:
+                player->lives--;
+                stats.hitsTaken++;
+                stats.combo = 0;
+                break;
                 
-            } else if (currentState == 2 || currentState == 3) { // Game Over o Victoria
-                switch (ch) {
-                    case 'r':
-                    case 'R':
-                        // Reiniciar protegido con mutexes
-                        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
-                        pthread_mutex_lock(data->engine->getThreadManager()->getGameStateMutex());
-                        
-                        data->engine->resetGame();
-                        
-                        pthread_mutex_unlock(data->engine->getThreadManager()->getGameStateMutex());
-                        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-                        break;
-                        
-                    case 'q':
-                    case 'Q':
-                    case 27: // ESC
-                        data->engine->setRunning(false);
-                        break;
-                }
+            case EVT_WAVE_CLEARED:
+                player->score += GameStats::WAVE_BONUS * event.value;
+                break;
+        }
+    }
+}
+
+// Victoria y derrota son lecturas O(1) de lo que la formación mantiene al
+// mover y matar invasores (vivos y fila viva más baja), sin recorrerla.
+// No toma locks propios: corre dentro del tick, como las demás fases.
+void ThreadManager::gameStateStep(GameEngine* engine) {
+    if (engine->getGameState() == 0) {
+        Player* player = engine->getPlayer();
+        InvaderFormation* invaders = engine->getInvaders();
+        int newState = 0;
+        
+        if (player->lives <= 0) {
+            newState = 2;
+        }
+        
+        // Si la última vida se perdió en el mismo tick, la partida termina
+        // en esta oleada: la siguiente no llega a armarse
+        if (newState == 0 && invaders->liveCount() == 0) {
+            if (engine->getWave() < engine->getFormation().waves) {
+                engine->nextWave();
+            } else {
+                newState = 3;
             }
         }
         
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
+        if (invaders->hasLive() && invaders->lowestY() >= engine->getScreenHeight() - 6) {
+            newState = 2;
+        }
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        if (newState != 0) {
+            engine->endGame(newState);
+        }
     }
-    
-    return nullptr;
 }
 
-// HILO 9: Actualización de puntaje
-void* ThreadManager::scoreUpdateFunc(void* arg) {
+// ===== Hilos =====
+
+// HILO 1: Planificador de ticks. Cada tick corre las fases en orden y
+// bloquea entityMutex una sola vez para todo el tick. El ritmo lo dan
+// deadlines absolutos; si hubo atraso, waitNext() indica cuántos ticks
+// correr según la política de recuperación.
+void* ThreadManager::tickFunc(void* arg) {
     ThreadData* data = static_cast<ThreadData*>(arg);
+    ThreadManager* manager = data->engine->getThreadManager();
+    LockProfile::nameThread("ticks");
+    
+    manager->tickPacer.start();
     
     while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getScoreMutex());
+        int ticks = manager->tickPacer.waitNext();
         
-        if (data->engine->getGameState() == 0) {
-            // Aquí podrían agregarse bonificaciones
+        for (int i = 0; i < ticks && *(data->running); i++) {
+            {
+                ScopedPhaseTimer wait(manager->perfStats, PerfStats::ENTITY_LOCK_WAIT);
+                manager->getEntityMutex()->lock();
+            }
+            
+            manager->runTick();
+            data->engine->publishSnapshot();
+            
+            manager->getEntityMutex()->unlock();
         }
         
-        pthread_mutex_unlock(data->engine->getThreadManager()->getScoreMutex());
-        
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        // Solo este hilo cambia el estado, así que leerlo aquí es seguro
+        if (data->engine->getGameState() != 0) {
+            manager->parkTicks();
+        }
     }
     
     return nullptr;
 }
 
-// HILO 10: Gestión del estado
-void* ThreadManager::gameStateFunc(void* arg) {
+// HILO 2: Renderizado (30 FPS por defecto, 60 o sin límite con --fps).
+// Dibuja la última instantánea publicada, sin tocar entityMutex: solo toma
+// renderMutex para usar la terminal. Su ritmo no afecta al de los ticks.
+void* ThreadManager::renderFunc(void* arg) {
     ThreadData* data = static_cast<ThreadData*>(arg);
+    ThreadManager* manager = data->engine->getThreadManager();
+    LockProfile::nameThread("render");
+    
+    manager->renderPacer.start();
     
     while (*(data->running)) {
-        pthread_mutex_lock(data->engine->getThreadManager()->getGameStateMutex());
-        pthread_mutex_lock(data->engine->getThreadManager()->getEntityMutex());
+        manager->renderPacer.waitNext();
+        
+        // Si el planificador ya duerme, este es el último frame hasta que
+        // despierte
+        manager->getGameStateMutex()->lock();
+        bool lastFrame = manager->tickParked;
+        if (lastFrame) {
+            manager->renderPending = false;
+        }
+        manager->getGameStateMutex()->unlock();
         
-        if (data->engine->getGameState() == 0) {
-            Player* player = data->engine->getPlayer();
-            
-            if (player->lives <= 0) {
-                data->engine->setGameState(2);
-            }
-            
-            std::vector<Entity>* invaders = data->engine->getInvaders();
-            bool allDestroyed = true;
-            for (const auto& invader : *invaders) {
-                if (invader.active) {
-                    allDestroyed = false;
-                    break;
-                }
-            }
-            
-            if (allDestroyed) {
-                data->engine->setGameState(3);
-            }
-            
-            for (const auto& invader : *invaders) {
-                if (invader.active && invader.y >= data->engine->getScreenHeight() - 6) {
-                    data->engine->setGameState(2);
-                    break;
-                }
-            }
+        {
+            ScopedPhaseTimer wait(manager->perfStats, PerfStats::RENDER_LOCK_WAIT);
+            manager->getRenderMutex()->lock();
         }
         
-        pthread_mutex_unlock(data->engine->getThreadManager()->getEntityMutex());
-        pthread_mutex_unlock(data->engine->getThreadManager()->getGameStateMutex());
+        bool drawn;
+        {
+            ScopedPhaseTimer timer(manager->perfStats, PerfStats::RENDER);
+            drawn = data->engine->render();
+        }
         
-        pthread_barrier_wait(&data->engine->getThreadManager()->updateBarrier);
+        manager->getRenderMutex()->unlock();
+        
+        // Sin límite de FPS y sin nada nuevo que dibujar: dormir hasta que
+        // el frame pueda cambiar en vez de girar. Si el tick ya está
+        // atrasado, solo ceder el núcleo hasta que se publique.
+        if (!drawn && manager->renderPacer.isUncapped()) {
+            auto until = data->engine->getFrameHeldUntil();
+            if (until > std::chrono::steady_clock::now()) {
+                std::this_thread::sleep_until(until);
+            } else {
+                std::this_thread::yield();
+            }
+        }
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        if (lastFrame) {
+            manager->parkRender();
+        }
     }
     
     return nullptr;
@@ -0,0 +1,114 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <thread>
+
+WorkerPool::WorkerPool(int threadCount)
+    : poolMutex("poolMutex"), job(nullptr), jobCount(0), nextIndex(0), completed(0),
+      generation(0), busyWorkers(0), stopping(false) {
+
+    pthread_cond_init(&workCondition, nullptr);
+    pthread_cond_init(&doneCondition, nullptr);
+
+    workers.resize(std::max(0, threadCount));
+    for (auto& worker : workers) {
+        pthread_create(&worker, nullptr, workerFunc, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    poolMutex.lock();
+    stopping = true;
+    pthread_cond_broadcast(&workCondition);
+    poolMutex.unlock();
+
+    for (auto& worker : workers) {
+        pthread_join(worker, nullptr);
+    }
+
+    pthread_cond_destroy(&doneCondition);
+    pthread_cond_destroy(&workCondition);
+}
+
+int WorkerPool::defaultSize(int maxWorkers) {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(0, std::min(maxWorkers, cores - 1));
+}
+
+// Toma índices del trabajo actual hasta agotarlos
+void WorkerPool::drainJob(const std::function<void(int)>& fn, int count) {
+    while (true) {
+        int index = nextIndex.fetch_add(1);
+        if (index >= count) {
+            break;
+        }
+        fn(index);
+        completed.fetch_add(1);
+    }
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    poolMutex.lock();
+    job = &fn;
+    jobCount = count;
+    nextIndex = 0;
+    completed = 0;
+    generation++;
+    pthread_cond_broadcast(&workCondition);
+    poolMutex.unlock();
+
+    // El hilo que llama también trabaja
+    drainJob(fn, count);
+
+    // Esperar a que se completen todos los índices y a que ningún
+    // trabajador siga dentro de este trabajo antes de publicar otro
+    poolMutex.lock();
+    while (completed.load() < count || busyWorkers > 0) {
+        poolMutex.wait(&doneCondition);
+    }
+    job = nullptr;
+    poolMutex.unlock();
+}
+
+void* WorkerPool::workerFunc(void* arg) {
+    WorkerPool* pool = static_cast<WorkerPool*>(arg);
+    unsigned long seenGeneration = 0;
+
+    LockProfile::nameThread("pool");
+
+    pool->poolMutex.lock();
+    while (true) {
+        while (!pool->stopping &&
+               (pool->generation == seenGeneration || pool->job == nullptr)) {
+            pool->poolMutex.wait(&pool->workCondition);
+        }
+        if (pool->stopping) {
+            break;
+        }
+
+        seenGeneration = pool->generation;
+        const std::function<void(int)>* fn = pool->job;
+        int count = pool->jobCount;
+        pool->busyWorkers++;
+        pool->poolMutex.unlock();
+
+        pool->drainJob(*fn, count);
+
+        pool->poolMutex.lock();
+        pool->busyWorkers--;
+        pthread_cond_signal(&pool->doneCondition);
+    }
+    pool->poolMutex.unlock();
+
+    return nullptr;
+}
@@ -0,0 +1,66 @@
+#include "WorldSnapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+SnapshotBuffer::SnapshotBuffer() : writeIndex(0), readIndex(1), middle(2) {
+}
+
+void SnapshotBuffer::publish() {
+    int previous = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+    writeIndex = previous & INDEX_MASK;
+}
+
+const WorldSnapshot& SnapshotBuffer::acquire() {
+    if (middle.load(std::memory_order_acquire) & FRESH) {
+        int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+    }
+    return slots[readIndex];
+}
+
+static int lerp(int from, int to, double alpha) {
+    return from + static_cast<int>(std::lround((to - from) * alpha));
+}
+
+InterpolatedPositions interpolatePositions(const WorldSnapshot& world, double alpha) {
+    InterpolatedPositions at;
+    at.originX = world.invaders.originX;
+    at.originY = world.invaders.originY;
+    at.playerX = world.player.x;
+    
+    // Un paso de una celda no tiene posición intermedia que mostrar: se
+    // dibuja ya, sin esperar a la mitad del tick
+    if (std::abs(world.player.x - world.previousPlayerX) > 1) {
+        at.playerX = lerp(world.previousPlayerX, world.player.x, alpha);
+    }
+    if (std::abs(world.invaders.originX - world.previousOriginX) > 1 ||
+        std::abs(world.invaders.originY - world.previousOriginY) > 1) {
+        at.originX = lerp(world.previousOriginX, world.invaders.originX, alpha);
+        at.originY = lerp(world.previousOriginY, world.invaders.originY, alpha);
+    }
+    return at;
+}
+
+double interpolationAlpha(const WorldSnapshot& world, std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - world.publishedAt).count();
+    return std::max(0.0, std::min(1.0, elapsed / world.tickSeconds));
+}
+
+std::chrono::steady_clock::time_point nextFrameChange(const WorldSnapshot& world,
+                                                      std::chrono::steady_clock::time_point now,
+                                                      bool interpolated) {
+    auto tickEnd = world.publishedAt + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(world.tickSeconds));
+    
+    int jump = std::max({std::abs(world.player.x - world.previousPlayerX),
+                         std::abs(world.invaders.originX - world.previousOriginX),
+                         std::abs(world.invaders.originY - world.previousOriginY)});
+    if (!interpolated || jump <= 1) {
+        return tickEnd;
+    }
+    
+    auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(world.tickSeconds / jump));
+    return std::min(tickEnd, now + step);
+}